@@ -0,0 +1,69 @@
+#pragma once
+// Minimal benchmark harness shared by the bench_* executables.
+//
+// Every measurement prints one JSON object on its own line, so results can be
+// appended to a file and diffed between releases:
+//
+//   {"suite":"sim","bench":"place_block","param":"tower","value":1000,
+//    "ops":1000,"samples":15,"ns_per_op":{"min":..,"p50":..,"p95":..,"mean":..}}
+//
+// Common flags: --samples N (default 15), --filter SUBSTRING (bench names)
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace bench {
+
+struct Options {
+  int samples = 15;
+  const char *filter = nullptr;
+};
+
+/// @brief Reads the common flags, leaves the rest to the caller
+inline Options ParseOptions(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--samples") == 0) options.samples = std::max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--filter") == 0) options.filter = argv[++i];
+  }
+  return options;
+}
+
+inline bool Selected(const Options& options, const char *bench) {
+  return !options.filter || strstr(bench, options.filter);
+}
+
+/// @brief Runs setup() untimed and op() timed, options.samples times, and
+/// prints the time per operation. op() is expected to perform ops operations.
+template <typename Setup, typename Op>
+void Run(const Options& options, const char *suite, const char *bench, const char *param, long long value,
+         size_t ops, Setup setup, Op op) {
+  if (!Selected(options, bench)) return;
+
+  std::vector<double> nsPerOp;
+  nsPerOp.reserve(options.samples);
+  for (int sample = 0; sample < options.samples; sample++) {
+    setup();
+    auto start = std::chrono::steady_clock::now();
+    op();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    nsPerOp.push_back(ns / ops);
+  }
+
+  std::sort(nsPerOp.begin(), nsPerOp.end());
+  double mean = 0.0;
+  for (double ns : nsPerOp) mean += ns;
+  mean /= nsPerOp.size();
+  auto percentile = [&](double p) { return nsPerOp[(size_t)(p * (nsPerOp.size() - 1) + 0.5)]; };
+
+  printf("{\"suite\":\"%s\",\"bench\":\"%s\",\"param\":\"%s\",\"value\":%lld,\"ops\":%zu,\"samples\":%d,"
+         "\"ns_per_op\":{\"min\":%.1f,\"p50\":%.1f,\"p95\":%.1f,\"mean\":%.1f}}\n",
+         suite, bench, param, value, ops, options.samples,
+         nsPerOp.front(), percentile(0.50), percentile(0.95), mean);
+  fflush(stdout);
+}
+
+}
@@ -0,0 +1,103 @@
+// Benchmarks that need a GL context: UI message storms and whole frames over
+// towers of growing height. The window stays hidden; on a machine without a
+// display run it under a virtual one, with Mesa's software rasterizer if there
+// is no GPU either:
+//
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a bench_render [--samples N] [--filter NAME] [--max-tower N]
+//
+// Run from the repo root, the shaders are loaded relative to it.
+#include "bench.h"
+#include "game.h"
+#include "raylib.h"
+#include "render/command_buffer.h"
+#include "util/frame_arena.h"
+#include <cstdlib>
+#include <cstring>
+
+const int WINDOW_WIDTH = 600;
+const int WINDOW_HEIGHT = 1000;
+const size_t TOWER_HEIGHTS[] = { 10, 100, 1000, 10000, 100000 };
+const size_t STORM_RATES[] = { 1, 32, 256 }; // Messages spawned per frame
+const int UI_FRAMES = 1000;
+const int RENDER_FRAMES = 30;
+
+static void BenchUIStorm(const bench::Options& options, Game& game) {
+  for (size_t rate : STORM_RATES) {
+    bench::Run(options, "ui", "ui_update_storm", "messages_per_frame", rate, UI_FRAMES,
+      [] {},
+      [&] {
+        for (int frame = 0; frame < UI_FRAMES; frame++) {
+          for (size_t i = 0; i < rate; i++) game.uiManager.SpawnPerfect();
+          game.uiManager.Update(1.0f / 60.0f);
+        }
+      });
+  }
+}
+
+static void RenderFrame(Game& game, render::CommandBuffer& commands) {
+  util::FrameArena::Instance().Reset();
+  commands.Begin();
+  BeginDrawing();
+    ClearBackground(RAYWHITE);
+    game.Render(commands);
+    commands.Submit();
+  EndDrawing();
+}
+
+/// @brief Whole frames looking at the top of a tower of each height, the
+/// view the game shows while playing one: the baked chunks in view, the
+/// unbaked blocks above them and the culling of everything below.
+static void BenchDrawTower(const bench::Options& options, Game& game, size_t maxTower) {
+  render::CommandBuffer commands;
+
+  for (size_t height : TOWER_HEIGHTS) {
+    if (height > maxTower) continue;
+
+    // A stress run builds the tower and puts the camera at its top. Start
+    // publishes that before the first step, stopping right away freezes it.
+    sim::StressSettings stress;
+    stress.enabled = true;
+    stress.towerHeight = height;
+    stress.debrisPerSecond = 0.0f;
+    game.simThread.SetStress(stress);
+    game.simThread.Start(nullptr);
+    game.simThread.Stop();
+    game.Update(0.0f); // Mirrors the new tower
+
+    // The first frame bakes the chunks, that is not what is measured
+    RenderFrame(game, commands);
+
+    bench::Run(options, "render", "draw_tower", "tower", height, RENDER_FRAMES,
+      [] {},
+      [&] { for (int frame = 0; frame < RENDER_FRAMES; frame++) RenderFrame(game, commands); });
+  }
+}
+
+int main(int argc, char **argv) {
+  bench::Options options = bench::ParseOptions(argc, argv);
+  size_t maxTower = 100000;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--max-tower") == 0) maxTower = strtoull(argv[++i], nullptr, 10);
+  }
+
+  // No vsync and no frame cap, EndDrawing returns as soon as the driver lets it
+  SetTraceLogLevel(LOG_WARNING);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Tower Blocks benchmarks");
+
+  {
+    // The UI frames render the initial snapshot, the tower ones a stress
+    // run's first one; the simulation never steps
+    Game game;
+    game.LoadResources();
+
+    BenchUIStorm(options, game);
+    BenchDrawTower(options, game, maxTower);
+
+    game.UnloadResources();
+  }
+
+  render::ResourceCache::Instance().UnloadAll();
+  CloseWindow();
+  return 0;
+}
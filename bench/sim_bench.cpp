@@ -0,0 +1,104 @@
+// Headless benchmarks of the simulation hot paths, no window needed.
+//
+//   bench_sim [--samples N] [--filter NAME] [--max-tower N] [--max-debris N]
+//
+// --max-debris caps the debris pool sizes swept by update_falling_blocks
+// (10k up to 1M by default), --max-tower the tower heights of place_block.
+#include "bench.h"
+#include "sim/fixed_timestep.h"
+#include "sim/random.h"
+#include "sim/simulation.h"
+#include "sim/stress.h"
+#include <cstdlib>
+#include <cstring>
+
+const size_t TOWER_HEIGHTS[] = { 10, 1000, 100000 };
+const size_t DEBRIS_COUNTS[] = { 10000, 100000, 1000000 };
+const size_t DEBRIS_TOWER_HEIGHT = 100;
+const int DEBRIS_STEPS = 10; // Steps timed per sample
+
+static void BenchPlaceBlock(const bench::Options& options, size_t maxTower) {
+  const size_t ops = 1000;
+  sim::Simulation simulation;
+
+  for (size_t height : TOWER_HEIGHTS) {
+    if (height > maxTower) continue;
+    bench::Run(options, "sim", "place_block", "tower", height, ops,
+      [&] { simulation.Reset(1); sim::BuildTower(simulation, height); },
+      [&] { for (size_t i = 0; i < ops; i++) sim::PlacePerfect(simulation); });
+  }
+}
+
+static void BenchCreateMovingBlock(const bench::Options& options) {
+  const size_t ops = 10000;
+  sim::Simulation simulation;
+
+  // Each call also adds a Movement, dropping it again keeps the store small
+  bench::Run(options, "sim", "create_moving_block", "tower", 1000, ops,
+    [&] { simulation.Reset(1); sim::BuildTower(simulation, 1000); },
+    [&] {
+      for (size_t i = 0; i < ops; i++) {
+        entity::Block block = simulation.CreateMovingBlock();
+        simulation.movements.Remove(block.Id());
+      }
+    });
+}
+
+/// @brief Scatters count pieces around the tower. Falling ones start high and
+/// spread out, resting ones sit still on the terrain around the tower.
+static void SpawnDebris(sim::Simulation& simulation, size_t count, bool resting) {
+  sim::Random random(7);
+  simulation.debris.Clear();
+
+  for (size_t i = 0; i < count; i++) {
+    float side = random.Range(0, 1) ? 1.0f : -1.0f;
+    Vector3 position = { side * (6.0f + random.Float() * 14.0f), 1.0f, (random.Float() - 0.5f) * 40.0f };
+    Vector3 velocity = { 0, 0, 0 };
+    Vector3 spin = { 0, 0, 0 };
+
+    if (!resting) {
+      position.y = 250.0f + random.Float() * 500.0f;
+      velocity = { random.Float() * 6.0f - 3.0f, random.Float() * 2.0f - 1.0f, random.Float() * 6.0f - 3.0f };
+      spin = { 2.0f, 1.0f, 0.5f };
+    }
+    simulation.debris.Spawn(position, { 1.0f, 2.0f, 1.0f }, velocity, spin, { 255, 255, 255, 255 });
+  }
+
+  // Resting pieces go to sleep after DEBRIS_SLEEP_STEPS
+  if (resting) {
+    for (int step = 0; step <= entity::DEBRIS_SLEEP_STEPS; step++) simulation.Step({}, sim::SIMULATION_STEP);
+  }
+}
+
+static void BenchUpdateFallingBlocks(const bench::Options& options, size_t maxDebris) {
+  sim::Simulation simulation;
+  sim::BuildTower(simulation, DEBRIS_TOWER_HEIGHT);
+
+  for (size_t count : DEBRIS_COUNTS) {
+    if (count > maxDebris) continue;
+    simulation.debris = entity::DebrisPool(count);
+
+    // Step() adds next to nothing on top of UpdateFallingBlocks while playing
+    for (bool resting : { false, true }) {
+      bench::Run(options, "sim", resting ? "update_falling_blocks_resting" : "update_falling_blocks", "debris",
+                 count, DEBRIS_STEPS,
+        [&] { SpawnDebris(simulation, count, resting); },
+        [&] { for (int step = 0; step < DEBRIS_STEPS; step++) simulation.Step({}, sim::SIMULATION_STEP); });
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  bench::Options options = bench::ParseOptions(argc, argv);
+  size_t maxTower = 100000;
+  size_t maxDebris = 1000000;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--max-tower") == 0) maxTower = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--max-debris") == 0) maxDebris = strtoull(argv[++i], nullptr, 10);
+  }
+
+  BenchPlaceBlock(options, maxTower);
+  BenchCreateMovingBlock(options);
+  BenchUpdateFallingBlocks(options, maxDebris);
+  return 0;
+}
@@ -1,51 +1,24 @@
 #pragma once
-#include <memory>
+#include <cstddef>
 #include "raylib.h"
-#include "raymath.h"
-#include "physics.h"
-#include "movement.h"
 #include "math/color.h"
 #include "entity/entity.h"
 
 namespace entity {
-  enum class BlockState { MOVING, PLACED, FALLING };
-
-  class Block: public Entity {
-  public:
-    // Core Data
+  /// @brief A tower block as plain data. Its index doubles as its EntityId;
+  /// moving state lives in a ComponentStore<Movement> and falling pieces live
+  /// in the DebrisPool, so a settled block carries nothing it does not use.
+  struct Block {
     size_t index;
+    Vector3 position;
     Vector3 size;
     math::Color color;
     int color_offset;
-    BlockState state;
-
-    // Optional Components
-    std::unique_ptr<Physics> physics = nullptr;
-    std::unique_ptr<Movement> movement = nullptr;
-
-    Block() : Entity({0,0,0}), index(0), size({1,1,1}), color({255,255,255,255}), state(BlockState::PLACED) {}
-    Block(size_t idx, Vector3 pos, Vector3 sz, math::Color col) 
-        : Entity(pos), index(idx), size(sz), color(col), state(BlockState::PLACED) {}
-
-    // Helper to turn this block into a falling piece
-    void SetFalling(Vector3 initialVelocity) {
-        state = BlockState::FALLING;
-        movement = nullptr; // Stop moving sideways
-        physics = std::make_unique<Physics>();
-        physics->velocity = initialVelocity;
-        physics->rotation_speed = { 2.0f, 1.0f, 0.5f };
-    }
 
-    void SetMoving(Movement config) {
-      this->state = BlockState::MOVING;
-      this->physics = nullptr;
-      this->movement = std::make_unique<Movement>(config);
-    }
+    Block() : index(0), position({0,0,0}), size({1,1,1}), color({255,255,255,255}), color_offset(0) {}
+    Block(size_t idx, Vector3 pos, Vector3 sz, math::Color col)
+        : index(idx), position(pos), size(sz), color(col), color_offset(0) {}
 
-    void SetPlaced() {
-      this->state = BlockState::PLACED;
-      this->movement = nullptr;
-      this->physics = nullptr;
-    }
+    EntityId Id() const { return (EntityId)index; }
   };
-}
\ No newline at end of file
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "entity/entity.h"
+#include <cstddef>
+#include <vector>
+
+namespace entity
+{
+
+/// @brief Dense storage for one component type, indexed by entity id.
+///
+/// Components sit contiguously in `dense` so iterating them is a linear walk;
+/// `sparse` maps an id to its slot. Only entities that actually have the
+/// component pay for it, and removal is a swap with the last slot.
+template <typename T>
+class ComponentStore
+{
+public:
+  T& Add(EntityId id, const T& component) {
+    if (id >= sparse.size()) sparse.resize(id + 1, INVALID_SLOT);
+
+    if (sparse[id] != INVALID_SLOT) {
+      dense[sparse[id]] = component;
+      return dense[sparse[id]];
+    }
+
+    sparse[id] = (uint32_t)dense.size();
+    dense.push_back(component);
+    owners.push_back(id);
+    return dense.back();
+  }
+
+  void Remove(EntityId id) {
+    if (!Has(id)) return;
+
+    uint32_t slot = sparse[id];
+    uint32_t last = (uint32_t)dense.size() - 1;
+    if (slot != last) {
+      dense[slot] = dense[last];
+      owners[slot] = owners[last];
+      sparse[owners[slot]] = slot;
+    }
+
+    dense.pop_back();
+    owners.pop_back();
+    sparse[id] = INVALID_SLOT;
+  }
+
+  bool Has(EntityId id) const { return id < sparse.size() && sparse[id] != INVALID_SLOT; }
+
+  T* Get(EntityId id) { return Has(id) ? &dense[sparse[id]] : nullptr; }
+  const T* Get(EntityId id) const { return Has(id) ? &dense[sparse[id]] : nullptr; }
+
+  void Clear() {
+    // Ids of a finished run are not reused for long, drop the whole index
+    dense.clear();
+    owners.clear();
+    sparse.clear();
+  }
+
+  size_t Size() const { return dense.size(); }
+  EntityId Owner(size_t slot) const { return owners[slot]; }
+
+  typename std::vector<T>::iterator begin() { return dense.begin(); }
+  typename std::vector<T>::iterator end() { return dense.end(); }
+  typename std::vector<T>::const_iterator begin() const { return dense.begin(); }
+  typename std::vector<T>::const_iterator end() const { return dense.end(); }
+private:
+  static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+  std::vector<T> dense;
+  std::vector<EntityId> owners;
+  std::vector<uint32_t> sparse;
+};
+
+}
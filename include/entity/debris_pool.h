@@ -0,0 +1,101 @@
+#pragma once
+#include "raylib.h"
+#include "entity/layer_hash.h"
+#include "math/color.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace entity {
+
+const size_t DEBRIS_POOL_CAPACITY = 1024;
+const float DEBRIS_KILL_HEIGHT = -50.0f;
+
+// Contact response
+const float DEBRIS_RESTITUTION = 0.3f;     // Share of the falling speed a bounce keeps
+const float DEBRIS_MIN_BOUNCE = 1.0f;      // Slower impacts do not bounce at all
+const float DEBRIS_FRICTION = 0.9f;        // Horizontal speed kept per step in contact
+const float DEBRIS_SPIN_DAMPING = 0.8f;    // Spin kept per step in contact
+const float DEBRIS_SETTLE_RATE = 0.15f;    // How fast a piece in contact rolls onto a face
+const float DEBRIS_CONTACT_SLOP = 0.05f;   // A piece this close above a face still rests on it
+
+// Sleeping
+const float DEBRIS_SLEEP_SPEED = 0.1f;     // Below this speed (and spin) a piece counts as resting
+const uint8_t DEBRIS_SLEEP_STEPS = 30;     // Resting steps before it goes to sleep
+
+/// @brief Fixed-capacity, struct-of-arrays storage for chopped debris.
+///
+/// Every attribute lives in its own contiguous array so Integrate() can step
+/// four pieces per SSE instruction. Pieces land on the top faces of a
+/// LayerHash, and once they have rested for DEBRIS_SLEEP_STEPS they go to
+/// sleep: the live range is split into sleepers [0, Sleeping()) and awake
+/// pieces [Sleeping(), Count()), and only the awake ones are stepped. The
+/// supports never go away during a run, so nothing wakes a sleeper again.
+///
+/// Awake pieces that fall below DEBRIS_KILL_HEIGHT are swap-removed. Nothing
+/// is allocated after construction; when the pool is full Spawn() recycles
+/// roughly the oldest sleeper, or drops the piece if every one is awake.
+class DebrisPool {
+public:
+  /// @brief Everything about one piece, for save files
+  struct Piece {
+    Vector3 position, lastPosition;
+    Vector3 velocity;
+    Vector3 rotation, lastRotation;
+    Vector3 spin;
+    Vector3 size;
+    math::Color color;
+    uint8_t restSteps;
+  };
+
+  float gravity = -15.0f; // Same pull as entity::Physics
+
+  explicit DebrisPool(size_t capacity = DEBRIS_POOL_CAPACITY);
+
+  bool Spawn(Vector3 position, Vector3 size, Vector3 velocity, Vector3 rotationSpeed, math::Color color);
+  void Update(float dt, const LayerHash& colliders, const TowerStore& tower);
+  void Clear() { count = 0; sleeping = 0; recycleCursor = 0; }
+
+  Piece Get(size_t i) const;
+  /// @brief Replaces the contents, the first sleeping pieces are asleep. Takes
+  /// at most Capacity() pieces.
+  void Assign(const Piece *pieces, size_t count, size_t sleeping);
+
+  size_t Count() const { return count; }
+  size_t Sleeping() const { return sleeping; }
+  size_t Capacity() const { return capacity; }
+
+  Vector3 Position(size_t i) const { return { posX[i], posY[i], posZ[i] }; }
+  Vector3 Rotation(size_t i) const { return { rotX[i], rotY[i], rotZ[i] }; }
+
+  /// @brief Blend between the previous and the current step, alpha in [0, 1]
+  Vector3 Position(size_t i, float alpha) const;
+  Vector3 Rotation(size_t i, float alpha) const;
+  Vector3 Size(size_t i) const { return { sizeX[i], sizeY[i], sizeZ[i] }; }
+  math::Color Color(size_t i) const { return colors[i]; }
+private:
+  size_t capacity;
+  size_t count = 0;
+  size_t sleeping = 0;
+  size_t recycleCursor = 0; // Next sleeper to give up its slot
+
+  std::vector<float> posX, posY, posZ;
+  std::vector<float> lastPosX, lastPosY, lastPosZ;
+  std::vector<float> velX, velY, velZ;
+  std::vector<float> rotX, rotY, rotZ;
+  std::vector<float> lastRotX, lastRotY, lastRotZ;
+  std::vector<float> spinX, spinY, spinZ;
+  std::vector<float> sizeX, sizeY, sizeZ;
+  std::vector<math::Color> colors;
+  std::vector<uint8_t> restSteps;
+
+  void Integrate(float dt);
+  void Collide(const LayerHash& colliders, const TowerStore& tower);
+  void Compact();
+  void Sleep(size_t i);
+  void Remove(size_t i);
+  void Move(size_t from, size_t to);
+  void Swap(size_t a, size_t b);
+};
+
+}
@@ -1,19 +1,11 @@
-#include "raylib.h"
-#include "raymath.h"
-#include "entity/physics.h"
-#include "entity/movement.h"
+#pragma once
+#include <cstdint>
 
 namespace entity
 {
-class Entity
-{
-public:
-  entity::Physics physics;
-  entity::Movement movement;
-  Vector3 position;
-
-  Entity(Vector3 pos): position(pos) {}
+/// @brief Entities are plain ids, their data lives in the component stores
+/// (see entity/component_store.h) and in the block records themselves.
+typedef uint32_t EntityId;
 
-  virtual ~Entity() = default;
-};
-}
\ No newline at end of file
+const EntityId INVALID_ENTITY = UINT32_MAX;
+}
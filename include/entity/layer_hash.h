@@ -0,0 +1,43 @@
+#pragma once
+#include "raylib.h"
+#include "entity/tower_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace entity {
+
+const float COLLISION_LAYER_HEIGHT = 2.0f; // One tower layer
+
+/// @brief Static boxes debris can land on, bucketed by the layer of their top face.
+///
+/// The hash is one-dimensional: the key is floor(top / layerHeight). The tower
+/// itself is not copied in: its blocks are one layer tall, so block i's top
+/// face is in layer i and FindSupport reads it straight from the TowerStore.
+/// The hash only holds the terrain and anything else that is not a tower
+/// block, and a lookup touches one or two layers however tall the tower is.
+/// Only top faces are solid, debris lands on things and slides off their
+/// edges but passes through their sides.
+class LayerHash {
+public:
+  explicit LayerHash(float layerHeight = COLLISION_LAYER_HEIGHT): layerHeight(layerHeight) {}
+
+  void Clear();
+  void Insert(Vector3 center, Vector3 size);
+
+  /// @brief Finds the highest top face, among the boxes and tower's blocks,
+  /// with a top in [low, high] that covers the point (x, z) and writes it to top
+  bool FindSupport(const TowerStore& tower, float x, float z, float low, float high, float& top) const;
+
+  size_t Size() const { return count; }
+private:
+  float layerHeight;
+  size_t count = 0;
+  float highest = 0.0f; // Top face of the highest box, anything above it is in free fall
+  std::unordered_map<int32_t, std::vector<BoundingBox>> cells;
+
+  int32_t Key(float y) const;
+};
+
+}
@@ -8,29 +8,48 @@ namespace entity
 enum Direction { FORWARD, BACKWARD };
 enum Axis      { X, Z };
 
+/// @brief Ping-pong between -threshold and threshold along one axis.
+///
+/// The motion is a triangle wave, so instead of accumulating steps the state
+/// is a phase: the distance travelled around one [0, 4 * threshold) cycle.
+/// Phase 0 sits at -threshold, the first half of the cycle moves FORWARD. Any
+/// moment, between steps included, can then be evaluated exactly.
 struct Movement {
     float speed;
     Direction direction;
     Axis axis;
     float threshold = 20.0f; // MOVEMENT_THRESHOLD moved here
+    float phase = 0.0f;
+
+    /// @brief Puts the cycle at axisPosition, heading in direction
+    void Start(float axisPosition) {
+        phase = (direction == FORWARD) ? axisPosition + threshold : 3.0f * threshold - axisPosition;
+    }
+
+    /// @brief Axis coordinate offset seconds after the current phase
+    float PositionAt(float offset) const {
+        float period = 4.0f * threshold;
+        float p = fmodf(phase + speed * offset, period);
+        if (p < 0) p += period;
+        return threshold - fabsf(p - 2.0f * threshold);
+    }
+
+    /// @brief Seconds until the block next passes axisPosition
+    float TimeUntil(float axisPosition) const {
+        float period = 4.0f * threshold;
+        float forward = fmodf(axisPosition + threshold - phase + period, period);
+        float backward = fmodf(3.0f * threshold - axisPosition - phase + period, period);
+        return fminf(forward, backward) / speed;
+    }
 
     void Update(Vector3& position, float dt) {
-        // Decide which coordinate to change
-        float* axisPosition = (axis == X) ? &position.x : &position.z;
+        // Keep the phase small so float precision does not decay over a long run
+        phase = fmodf(phase + speed * dt, 4.0f * threshold);
+        direction = (phase < 2.0f * threshold) ? FORWARD : BACKWARD;
 
-        // Apply movement
-        int dirMultiplier = (direction == FORWARD) ? 1 : -1;
-        *axisPosition += dirMultiplier * speed * dt;
-
-        // Handle the "Ping-Pong" bounce
-        if (fabs(*axisPosition) >= threshold) {
-            direction = (direction == FORWARD) ? BACKWARD : FORWARD;
-            
-            // Clamp it so it doesn't get stuck outside the threshold
-            if (*axisPosition > threshold) *axisPosition = threshold;
-            if (*axisPosition < -threshold) *axisPosition = -threshold;
-        }
+        float* axisPosition = (axis == X) ? &position.x : &position.z;
+        *axisPosition = PositionAt(0.0f);
     }
 };
 
-}
\ No newline at end of file
+}
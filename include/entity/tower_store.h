@@ -0,0 +1,65 @@
+#pragma once
+#include "raylib.h"
+#include "entity/block.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace entity {
+
+// Fixed point scales of a PackedBlock
+const float TOWER_POSITION_SCALE = 1024.0f; // X/Z centers within +-32 units, ~0.001 steps
+const float TOWER_SIZE_SCALE = 4096.0f;     // X/Z sizes up to 16 units
+const float TOWER_HEIGHT_SCALE = 16.0f;     // Heights up to 15.9 units
+
+/// @brief A settled tower block in 16 bytes.
+struct PackedBlock {
+  float y;
+  int16_t x;
+  int16_t z;
+  uint16_t sizeX;
+  uint16_t sizeZ;
+  uint8_t sizeY;
+  uint8_t r, g, b;
+};
+
+static_assert(sizeof(PackedBlock) == 16, "PackedBlock must stay 16 bytes");
+
+PackedBlock Pack(const Block& block);
+Block Unpack(const PackedBlock& packed, size_t index);
+
+/// @brief The placed blocks of a tower.
+///
+/// Only the top block, the one the next placement is cut against, is kept as
+/// a full Block. Everything below it is settled for good and stored as a
+/// quantized PackedBlock, so a million blocks take 16 MB. Blocks are referred
+/// to by index, which stays valid however the storage grows.
+class TowerStore {
+public:
+  void Clear();
+  void Reserve(size_t blocks) { settled.reserve(blocks); }
+
+  /// @brief Settles the current top block and makes block the new top
+  void Push(const Block& block);
+  /// @brief Replaces the tower with count settled records and top above them
+  void Assign(const PackedBlock *records, size_t count, const Block& top);
+
+  size_t Size() const { return hasTop ? settled.size() + 1 : 0; }
+  bool Empty() const { return !hasTop; }
+
+  Block& Top() { return top; }
+  const Block& Top() const { return top; }
+  /// @brief Block i, dequantized unless it is the top one
+  Block Get(size_t i) const { return i == settled.size() ? top : Unpack(settled[i], i); }
+
+  /// @brief The Size() - 1 settled records, bottom to top
+  const PackedBlock *SettledData() const { return settled.data(); }
+
+  size_t MemoryBytes() const { return sizeof(*this) + settled.capacity() * sizeof(PackedBlock); }
+private:
+  std::vector<PackedBlock> settled;
+  Block top;
+  bool hasTop = false;
+};
+
+}
@@ -1,68 +1,85 @@
 #pragma once
-#include "entity/block.h"
+#include "sim/sim_thread.h"
 #include "animations/score_animation.h"
 #include "animations/overlay_animation.h"
 #include "ui/ui_manager.h"
-#include <vector>
+#include "render/block_renderer.h"
+#include "render/command_buffer.h"
+#include "render/material.h"
+#include "render/resource_cache.h"
+#include "render/tower_chunks.h"
 
 // CONSTANTS
-const int MOVEMENT_THRESHOLD = 16;
-
 const float SCORE_ANIMATION_DURATION = 0.2;
 const float SCORE_ANIMATION_SCALE = 1.5;
 
 const int OVERLAY_ANIMATION_OFFSET_Y = -50;
 const float FADE_SPEED = 2.5;
 
+const char *const REPLAY_FILE = "replays.tbr";
+const char *const SAVE_FILE = "suspend.tbs"; // Run in progress at quit, resumed on the next start
 
-typedef enum {
-  READY_STATE,
-  PLAYING_STATE,
-  GAME_OVER_STATE
-} GameState;
-
+/// @brief Raylib front end: stamps device input for the simulation thread and
+/// renders the tower, debris and HUD from its latest snapshot.
 class Game {
 public:
   Game();
 
-  Camera3D mainCamera;
+  Camera3D mainCamera;      // Camera at the latest snapshot
+  Camera3D renderCamera;    // Blended towards it from the step before, what actually gets drawn
   Camera3D gameOverCamera;
-  GameState state;
-  Shader lighting_shader;
-  Model cube_model;
-  std::vector<entity::Block> placed_blocks;
-  std::vector<entity::Block> falling_blocks;
-  entity::Block current_block;
-  entity::Block *previous_block;
-  size_t previousBlockIndex = 0;
+  render::LightingMaterial lighting_material;
+  render::LightingMaterial tower_lighting_material;
+  Material tower_material;
+  render::MeshHandle cube_mesh;
+  Material cube_material;
+  render::BlockRenderer blockRenderer;
+  render::TowerChunks towerChunks;
+  sim::SimulationThread simThread;
+  entity::TowerStore tower; // Render-side copy of the placed blocks
   animations::ScoreAnimation scoreAnimation;
   animations::OverlayAnimation overlayAnimation;
   ui::UIManager uiManager;
 
+  /// @brief GPU assets come from render::ResourceCache and live for the whole
+  /// session, InitGame only resets state
+  void LoadResources();
+  void UnloadResources();
+  /// @brief Starts and stops the simulation thread
+  void Start();
+  void Stop();
+  /// @brief Snapshot of the whole run, only while stopped
+  bool SaveState(const char *path);
+  /// @brief Before Start: resumes the run saved in path. Error() of the failed
+  /// read goes to error, if given.
+  bool LoadState(const char *path, const char **error = nullptr);
+  /// @brief Resets render-side state, called when a new run starts
   void InitGame();
-  void Update(float dt);
-  void Render(float dt);
+  /// @brief Called right after every input poll, stamps new presses and hands
+  /// them to the simulation thread
+  void HandleInput();
+  /// @brief Called once per frame, picks up the latest snapshot
+  void Update(float frameTime);
+  /// @brief Records the scene, HUD and post passes, the caller submits them
+  void Render(render::CommandBuffer& commands);
 private:
-  /// @brief Action methods
-  entity::Block CreateMovingBlock();
-  void PlaceBlock();
-  entity::Block CreateFallingBlock(Vector3 position, Vector3 size, math::Color color);
-  entity::Block& GetPreviousBlock();
+  uint32_t generation = 0;
+  uint64_t perfectCount = 0;
+  sim::SaveWriter saveWriter; // Keeps its buffer between saves
 
   /// @brief Update methods
-  void UpdateGameState();
-  void UpdateCameraPosition(float dt);
-  void UpdateCurrentBlock(float dt);
+  void SyncTower(const sim::FrameSnapshot& snapshot);
+  void UpdateGameState(const sim::FrameSnapshot& snapshot);
+  void UpdateCamera(const sim::FrameSnapshot& snapshot, float alpha);
   void UpdateScore(float dt);
   void UpdateOverlay(float dt);
-  void UpdateFallingBlocks(float dt);
 
   /// @brief Render methods
-  void Render3D();
+  void Render3D(const sim::FrameSnapshot& snapshot, float alpha, render::CommandBuffer& commands);
+  void DrawHUD();
 
   // 3D Rendering
   void DrawPlacedBlocks();
-  void DrawFallingBlocks();
-  void DrawCurrentBlock();
-  void DrawBlock(const entity::Block *block, Shader lightingShader);
+  void DrawFallingBlocks(const sim::FrameSnapshot& snapshot, float alpha);
+  void DrawCurrentBlock(const sim::FrameSnapshot& snapshot, float alpha);
 };
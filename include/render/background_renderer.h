@@ -0,0 +1,68 @@
+#pragma once
+#include "raylib.h"
+#include "render/material.h"
+#include "render/resource_cache.h"
+#include "render/scaled_target.h"
+#include <cstdint>
+
+namespace render {
+
+enum class BackgroundMode {
+  EVERY_FRAME, // Full shader pass every frame
+  AMORTIZED    // Keyframes built a band at a time, blended in between
+};
+
+struct BackgroundSettings {
+  BackgroundMode mode = BackgroundMode::AMORTIZED;
+  float keyframeInterval = 1.0f / 20.0f; // Seconds between keyframes
+  int bands = 4;                         // Horizontal slices per keyframe
+};
+
+/// @brief The animated balatro background.
+///
+/// In AMORTIZED mode the shader is evaluated into keyframes at fixed points in
+/// time. While the frame between keyframes k and k+1 is shown as a blend of
+/// the two, keyframe k+2 is built one band at a time, so each frame only pays
+/// for about bands / (interval * fps) of a full pass plus two texture reads.
+/// The shader is purely a function of time, so rendering keyframes ahead of
+/// the clock is exact.
+class BackgroundRenderer {
+public:
+  void Load();
+  void Unload();
+
+  /// @brief Draws the background for time over the whole window, scale is the
+  /// internal resolution from the ResolutionGovernor
+  void Draw(double time, float scale);
+  /// @brief AMORTIZED only: brings the keyframes up to time without drawing
+  /// them, for a later pass that blends Keyframe(0) and Keyframe(1) by Blend()
+  void Update(double time, float scale);
+
+  Texture2D Keyframe(int index) const { return slots[index].Get().texture; }
+  float Blend() const { return blend; }
+
+  /// @brief Drops the keyframes, the next Draw rebuilds them (e.g. after a mode change)
+  void Invalidate() { keyIndex = -1; }
+  int BandsRenderedLastFrame() const { return bandsLastFrame; }
+
+  BackgroundSettings settings;
+private:
+  BackgroundMaterial material;
+  ScaledTarget directTarget{"background"};
+  Texture2D quadTexture = {};
+
+  // slots[0] = keyframe k, slots[1] = k+1, slots[2] = k+2 under construction
+  RenderTextureHandle slots[3];
+  int64_t keyIndex = -1;
+  int bandsDone = 0;
+  int bandsLastFrame = 0;
+  float blend = 0.0f;
+  int width = 0;
+  int height = 0;
+
+  void DrawEveryFrame(double time, float scale);
+  void Prime(int64_t key);
+  void RenderBands(const RenderTextureHandle& slot, int64_t key, int firstBand, int endBand);
+};
+
+}
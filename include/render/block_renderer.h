@@ -0,0 +1,38 @@
+#pragma once
+#include "raylib.h"
+#include "math/color.h"
+#include "render/command_buffer.h"
+#include "util/frame_arena.h"
+#include <cstddef>
+
+namespace render {
+
+/// @brief Collects every block drawn during a frame and submits them all with
+/// a single DrawMeshInstanced call, so the draw-call count does not grow with
+/// the tower.
+///
+/// Each instance is one transform matrix. The bottom row of an affine
+/// transform is always (0, 0, 0, 1), so the block color is packed into the
+/// first three entries of that row and unpacked by the instanced lighting
+/// vertex shader (shaders/3d/lighting_instanced_vertex.glsl).
+///
+/// The instance list only lives for one frame and comes from the frame arena,
+/// sized up front from the previous frame's count.
+class BlockRenderer {
+public:
+  /// @brief Points the shader's MVP/model locations at the instancing inputs.
+  static void BindInstancing(Shader& shader);
+
+  void Begin();
+  void Submit(Vector3 position, Vector3 size, math::Color color);
+  void Submit(Vector3 position, Vector3 size, Vector3 rotation, math::Color color);
+  /// @brief Records the draw, the instances stay in place until the next Begin
+  void Flush(const Mesh& mesh, const Material& material, CommandBuffer& commands);
+
+  size_t Count() const { return instances.size(); }
+private:
+  util::ArenaVector<Matrix> instances;
+  size_t lastCount = 0;
+};
+
+}
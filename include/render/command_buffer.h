@@ -0,0 +1,126 @@
+#pragma once
+#include "raylib.h"
+#include "util/frame_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace render {
+
+// Passes run in this order. Only OPAQUE_3D is reordered by state, the others
+// blend and keep the order their commands were recorded in.
+enum class RenderPass : uint8_t {
+  BACKGROUND, // Straight to the backbuffer
+  OPAQUE_3D,  // Inside BeginMode3D with the recorded camera, depth tested
+  UI,         // HUD into the UI canvas
+  POST,       // Canvas composite over the scene
+  COUNT
+};
+
+// Commands per frame, the sort key keeps a 20 bit record index
+const size_t COMMAND_BUFFER_MAX = 1 << 20;
+
+/// @brief What the last Submit() cost. Custom commands issue whatever they
+/// like and are counted once each, not per draw or state change inside them.
+struct RenderStats {
+  size_t commands = 0;
+  size_t drawCalls = 0;      // Mesh and instanced draws
+  size_t customs = 0;
+  size_t shaderChanges = 0;
+  size_t textureChanges = 0;
+  size_t meshChanges = 0;    // Vertex array binds
+
+  size_t StateChanges() const { return shaderChanges + textureChanges + meshChanges; }
+};
+
+/// @brief Draw commands recorded during a frame and submitted together.
+///
+/// Recording only appends a command and its 64 bit sort key; Submit() sorts
+/// the keys once and walks them pass by pass. In OPAQUE_3D the key is (shader,
+/// diffuse texture, mesh, record index), so meshes sharing a material end up
+/// next to each other and are drawn with the shader, view/projection, texture
+/// and vertex array bound once, instead of raylib's DrawMesh setting all of it
+/// up and tearing it down for every call.
+///
+/// Commands, keys and custom callbacks live in the frame arena: Begin() has to
+/// run after each FrameArena::Reset and before the first command. Meshes and
+/// instance transforms are referenced, not copied, and must stay alive until
+/// Submit(). Main thread only.
+class CommandBuffer {
+public:
+  void Begin();
+
+  /// @brief Camera for the OPAQUE_3D pass
+  void SetCamera(const Camera3D& camera) { this->camera = camera; }
+  /// @brief Renders pass into target, cleared to transparent first, instead
+  /// of the current framebuffer. Kept across frames, nullptr resets it.
+  void SetTarget(RenderPass pass, const RenderTexture2D *target);
+
+  /// @brief Only the diffuse map of material is bound
+  void DrawMesh(RenderPass pass, const Mesh& mesh, const Material& material, Matrix transform);
+  /// @brief Goes through raylib's DrawMeshInstanced, which manages the instance buffer
+  void DrawMeshInstanced(RenderPass pass, const Mesh& mesh, const Material& material, const Matrix *transforms, int instances);
+
+  /// @brief Runs fn at its place in the pass, for draws that do not fit a
+  /// mesh command (rlgl batches, render texture passes). shaderId only sorts
+  /// it among OPAQUE_3D meshes. fn is copied into the frame arena and never
+  /// destroyed.
+  template <typename F>
+  void Custom(RenderPass pass, F fn, unsigned int shaderId = 0) {
+    static_assert(std::is_trivially_destructible<F>::value, "arena storage is dropped without destructors");
+    void *storage = util::FrameArena::Instance().Allocate(sizeof(F), alignof(F));
+
+    Command command = {};
+    command.type = Command::CUSTOM;
+    command.data = new (storage) F(std::move(fn));
+    command.invoke = [](void *data) { (*(F *)data)(); };
+    Record(pass, command, shaderId, 0, 0);
+  }
+
+  /// @brief Sorts and issues everything recorded since Begin()
+  void Submit();
+
+  const RenderStats& Stats() const { return stats; }
+  size_t Count() const { return commands.size(); }
+private:
+  struct Command {
+    enum Type : uint8_t { MESH, INSTANCED, CUSTOM } type;
+    const Mesh *mesh;
+    Material material;
+    Matrix transform;         // MESH
+    const Matrix *transforms; // INSTANCED
+    int instances;
+    void (*invoke)(void *);   // CUSTOM
+    void *data;
+  };
+
+  // GL state left bound by the previous mesh command
+  struct Bound {
+    unsigned int shader = 0;
+    unsigned int texture = 0;
+    unsigned int vertexArray = 0;
+    bool hasColor = false;
+    Color color;
+    bool hasTransform = false;
+    Matrix transform;
+    Matrix view;
+    Matrix projection;
+  };
+
+  util::ArenaVector<Command> commands;
+  util::ArenaVector<uint64_t> keys;
+  size_t lastCount = 0;
+  Camera3D camera = {};
+  RenderTexture2D targets[(int)RenderPass::COUNT] = {};
+  Bound bound;
+  RenderStats stats;
+
+  void Record(RenderPass pass, const Command& command, unsigned int shader, unsigned int texture, unsigned int mesh);
+  void SubmitRange(size_t first, size_t end);
+  void SubmitMesh(const Command& command);
+  void Unbind();
+};
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "raylib.h"
+#include "render/resource_cache.h"
+#include <cstring>
+
+namespace render {
+
+/// @brief Typed handle to a shader uniform. The location is resolved once when
+/// the shader is loaded, and Set() only uploads when the value differs from the
+/// last one sent to the GPU.
+template <typename T, int UniformType>
+class Uniform {
+public:
+  void Bind(Shader shader, const char *name) {
+    this->shader = shader;
+    this->location = GetShaderLocation(shader, name);
+    this->uploaded = false;
+  }
+
+  void Set(const T& value) {
+    if (location < 0) return;
+    if (uploaded && memcmp(&value, &last, sizeof(T)) == 0) return;
+
+    SetShaderValue(shader, location, &value, UniformType);
+    last = value;
+    uploaded = true;
+  }
+
+  bool IsBound() const { return location >= 0; }
+private:
+  Shader shader = {};
+  int location = -1;
+  T last = {};
+  bool uploaded = false;
+};
+
+/// @brief Sampler for a texture beyond texture0. raylib only keeps the binding
+/// for the next batch draw, so Set() goes inside the BeginShaderMode block of
+/// every draw that samples it and is never skipped.
+class TextureUniform {
+public:
+  void Bind(Shader shader, const char *name) {
+    this->shader = shader;
+    this->location = GetShaderLocation(shader, name);
+  }
+
+  void Set(Texture2D texture) {
+    if (location >= 0) SetShaderValueTexture(shader, location, texture);
+  }
+private:
+  Shader shader = {};
+  int location = -1;
+};
+
+using FloatUniform = Uniform<float, SHADER_UNIFORM_FLOAT>;
+using Vec2Uniform  = Uniform<Vector2, SHADER_UNIFORM_VEC2>;
+using Vec3Uniform  = Uniform<Vector3, SHADER_UNIFORM_VEC3>;
+
+/// @brief A shader plus the uniform handles a render pass needs from it. The
+/// shader comes from the ResourceCache, so materials built from the same files
+/// share one program (and should then not rely on Uniform's upload skipping).
+class ShaderMaterial {
+public:
+  Shader shader = {};
+  ShaderHandle handle;
+
+  bool IsLoaded() const { return shader.id != 0; }
+  void Unload();
+protected:
+  void LoadShaderFiles(const char *vsFileName, const char *fsFileName);
+};
+
+enum class LightingVariant {
+  INSTANCED,  // lighting_instanced_vertex.glsl, color comes from the instance
+  STATIC_MESH // lighting_vertex.glsl, per-vertex colors tinted by blockColor
+};
+
+/// @brief Lit blocks (shaders/3d).
+class LightingMaterial : public ShaderMaterial {
+public:
+  Vec3Uniform blockColor;
+  Vec3Uniform cameraPosition;
+
+  void Load(LightingVariant variant);
+};
+
+/// @brief Chromatic aberration + bloom over the UI canvas (shaders/ui/ui_post.glsl).
+class PostMaterial : public ShaderMaterial {
+public:
+  FloatUniform effectIntensity;
+  FloatUniform time;
+
+  void Load();
+};
+
+/// @brief Background keyframes, the offscreen 3D scene and the UI post effect
+/// in one full-screen pass (shaders/ui/ui_composite.fs). texture0 is the UI
+/// canvas.
+class CompositeMaterial : public ShaderMaterial {
+public:
+  TextureUniform scene;
+  TextureUniform background0;
+  TextureUniform background1;
+  FloatUniform backgroundBlend;
+  FloatUniform effectIntensity;
+
+  void Load();
+};
+
+/// @brief Full-screen animated background (shaders/ui/balatro.fs).
+class BackgroundMaterial : public ShaderMaterial {
+public:
+  FloatUniform iTime;
+  Vec2Uniform iResolution;
+
+  void Load();
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace render {
+
+struct GovernorSettings {
+  float targetFrameMs = 1000.0f / 60.0f;
+  float minScale = 0.5f;      // Quality floor
+  float maxScale = 1.0f;
+  float scaleStep = 0.125f;   // Coarse steps keep render texture reallocations rare
+  float smoothing = 0.1f;     // EMA weight of the newest frame
+  float overBudget = 1.10f;   // EMA above target * this drops a step...
+  int dropFrames = 20;        // ...once it has held for this many frames
+  float onBudget = 1.03f;     // EMA below target * this counts as comfortable
+  int probeFrames = 180;      // Comfortable frames before trying a step up
+  int maxProbeFrames = 180 * 16;
+};
+
+/// @brief Picks the internal resolution scale of the fullscreen shader passes
+/// from a moving average of recent frame times.
+///
+/// With vsync or a frame limiter the frame time never drops below the target,
+/// so "fast enough" cannot be read off it directly. Instead the governor
+/// probes: after a comfortable stretch it steps up, and if that step gets
+/// undone right away the wait before the next probe doubles. Dropping needs a
+/// sustained overrun, raising needs a much longer good stretch; together with
+/// the backoff that keeps it from oscillating between two steps.
+class ResolutionGovernor {
+public:
+  explicit ResolutionGovernor(GovernorSettings settings = GovernorSettings());
+
+  /// @brief Feed the last frame time once per frame, returns the new scale
+  float Update(float frameMs);
+  float Scale() const { return scale; }
+  float AverageFrameMs() const { return average; }
+
+  GovernorSettings settings;
+private:
+  float scale;
+  float average;
+  int overFrames = 0;
+  int comfortableFrames = 0;
+  int framesSinceRaise = 0;
+  int probeInterval;
+  bool justRaised = false;
+};
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "raylib.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace render {
+
+template <typename T>
+struct CachedResource {
+  T resource;
+  int refs = 0;
+  bool loaded = false;
+};
+
+/// @brief Shared, reference-counted access to a cached GPU resource. Copies
+/// share the resource; releasing the last handle keeps it cached, so the next
+/// acquire (e.g. after a restart) costs a map lookup instead of a reload.
+template <typename T>
+class Handle {
+public:
+  Handle() = default;
+  explicit Handle(CachedResource<T> *entry): entry(entry) { if (entry) entry->refs++; }
+  Handle(const Handle& other): Handle(other.entry) {}
+  Handle(Handle&& other) noexcept : entry(other.entry) { other.entry = nullptr; }
+  ~Handle() { Reset(); }
+
+  Handle& operator=(Handle other) {
+    std::swap(entry, other.entry);
+    return *this;
+  }
+
+  void Reset() {
+    if (entry) entry->refs--;
+    entry = nullptr;
+  }
+
+  bool IsValid() const { return entry && entry->loaded; }
+  const T& Get() const { return entry->resource; }
+  int RefCount() const { return entry ? entry->refs : 0; }
+private:
+  CachedResource<T> *entry = nullptr;
+};
+
+typedef Handle<Shader> ShaderHandle;
+typedef Handle<Mesh> MeshHandle;
+typedef Handle<RenderTexture2D> RenderTextureHandle;
+
+/// @brief Loads every shader, mesh and render texture once per session.
+///
+/// Resources are keyed by their file names (or a caller-chosen name for
+/// generated ones). UnloadAll() frees the GPU objects at shutdown; entries
+/// themselves live until the cache is destroyed, so handles released later
+/// stay harmless.
+class ResourceCache {
+public:
+  static ResourceCache& Instance();
+
+  ShaderHandle AcquireShader(const char *vsFileName, const char *fsFileName);
+  MeshHandle AcquireMesh(const char *name, const std::function<Mesh()>& generate);
+  /// @brief Resizes the named texture in place only when no handle holds it,
+  /// so release the old handle before acquiring a new size
+  RenderTextureHandle AcquireRenderTexture(const char *name, int width, int height);
+
+  /// @brief Frees resources no handle refers to anymore
+  void UnloadUnused();
+  /// @brief Frees everything, call before CloseWindow
+  void UnloadAll();
+private:
+  std::unordered_map<std::string, std::unique_ptr<CachedResource<Shader>>> shaders;
+  std::unordered_map<std::string, std::unique_ptr<CachedResource<Mesh>>> meshes;
+  std::unordered_map<std::string, std::unique_ptr<CachedResource<RenderTexture2D>>> renderTextures;
+
+  template <typename T>
+  CachedResource<T> *Find(std::unordered_map<std::string, std::unique_ptr<CachedResource<T>>>& map, const std::string& key);
+};
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "raylib.h"
+#include "render/resource_cache.h"
+
+namespace render {
+
+/// @brief Offscreen target for a fullscreen pass rendered at a fraction of the
+/// window resolution and stretched back up with bilinear filtering.
+///
+/// At scale 1 no offscreen texture is used; Begin/End do nothing and the pass
+/// draws straight to the current target as before.
+class ScaledTarget {
+public:
+  explicit ScaledTarget(const char *name): name(name) {}
+
+  /// @brief Starts drawing into the scaled target, returns its size
+  Vector2 Begin(float scale);
+  void End();
+  /// @brief Stretches the result over the whole window
+  void Draw();
+
+  bool IsScaled() const { return scaled; }
+private:
+  const char *name;
+  RenderTextureHandle handle;
+  RenderTexture2D target = {};
+  bool scaled = false;
+};
+
+/// @brief Draws source over rect with texture coordinates 0..1 (flipped
+/// vertically when source is a render texture), the quad every fullscreen
+/// pass shader runs on.
+void DrawFullscreenQuad(Texture2D source, Rectangle rect, bool flipY);
+
+}
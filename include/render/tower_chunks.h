@@ -0,0 +1,51 @@
+#pragma once
+#include "raylib.h"
+#include "render/command_buffer.h"
+#include "entity/tower_store.h"
+#include <vector>
+
+namespace render {
+
+// Blocks per baked chunk (24 vertices each, must stay under the 16 bit index limit)
+const size_t TOWER_CHUNK_SIZE = 64;
+
+struct TowerChunk {
+  Mesh mesh;
+  size_t firstBlock;
+  Vector3 boundsMin;
+  Vector3 boundsMax;
+};
+
+/// @brief Bakes runs of settled tower blocks into merged static meshes with
+/// per-vertex colors. Chunks are stored bottom to top, so the ones inside the
+/// camera's view volume are found with a binary search on their Y range
+/// instead of walking the whole tower every frame.
+class TowerChunks {
+public:
+  /// @brief Bakes every complete run of TOWER_CHUNK_SIZE blocks not baked yet.
+  void Sync(const entity::TowerStore& blocks);
+
+  /// @brief Records the chunks that overlap the orthographic camera's view.
+  /// They share material and transform, so the command buffer only rebinds
+  /// the vertex array between them.
+  void Draw(const Camera3D& camera, float aspect, const Material& material, CommandBuffer& commands);
+
+  /// @brief Unloads every chunk mesh, used on restart and shutdown.
+  void Clear();
+
+  /// @brief Blocks below this index are drawn by the chunks.
+  size_t BakedCount() const { return chunks.size() * TOWER_CHUNK_SIZE; }
+  size_t VisibleCount() const { return visibleCount; }
+private:
+  std::vector<TowerChunk> chunks;
+  // Union of every chunk's X/Z extents, keeps the Y projection conservative
+  Vector3 footprintMin = { 0, 0, 0 };
+  Vector3 footprintMax = { 0, 0, 0 };
+  size_t visibleCount = 0;
+  // Index pattern of a full chunk, every chunk mesh points at it
+  std::vector<unsigned short> indices;
+
+  TowerChunk Bake(const entity::TowerStore& blocks, size_t first);
+};
+
+}
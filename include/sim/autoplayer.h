@@ -0,0 +1,42 @@
+#pragma once
+#include "sim/simulation.h"
+#include "sim/random.h"
+#include <cstdint>
+
+namespace sim {
+
+/// @brief How well the bot plays. Errors are applied to the press time, the
+/// same way a human misses: by reacting a little early or late.
+struct SkillProfile {
+  const char *name;
+  float reactionJitter;   // Std deviation of the press timing error, seconds
+  float reactionBias;     // Mean timing error, positive presses late
+  float blunderChance;    // Chance per block of a much larger timing error
+  float blunderJitter;    // Std deviation of that larger error, seconds
+
+  static SkillProfile Perfect() { return { "perfect", 0.0f,   0.0f,   0.0f,   0.0f  }; }
+  static SkillProfile Expert()  { return { "expert",  0.010f, 0.002f, 0.005f, 0.08f }; }
+  static SkillProfile Casual()  { return { "casual",  0.025f, 0.010f, 0.02f,  0.12f }; }
+  static SkillProfile Novice()  { return { "novice",  0.050f, 0.020f, 0.05f,  0.20f }; }
+};
+
+/// @brief Headless player: reads the moving block's Movement and the previous
+/// block, works out the moment they line up, then presses at that moment plus
+/// an error drawn from its SkillProfile.
+class AutoPlayer {
+public:
+  AutoPlayer(SkillProfile skill, uint64_t seed): skill(skill), random(seed) {}
+
+  Input Decide(const Simulation& simulation, float dt);
+private:
+  SkillProfile skill;
+  Random random;
+  entity::EntityId plannedBlock = entity::INVALID_ENTITY;
+  uint64_t pressTick = 0;
+  uint8_t pressSubTick = 0;
+
+  void Plan(const Simulation& simulation, float dt);
+  float Gaussian();
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace sim {
+
+const float SIMULATION_STEP = 1.0f / 120.0f;
+const int MAX_CATCHUP_STEPS = 8;
+
+/// @brief Accumulator for running the simulation at a fixed rate no matter
+/// how fast frames are presented.
+///
+/// Advance() turns the frame's elapsed time into a number of whole steps. When
+/// a hitch would need more than maxSteps, the backlog is dropped instead of
+/// spiralling, so the game slows down for a moment rather than teleporting.
+/// Alpha() is how far the renderer sits between the last two steps.
+class FixedTimestep {
+public:
+  explicit FixedTimestep(float step = SIMULATION_STEP, int maxSteps = MAX_CATCHUP_STEPS)
+    : step(step), maxSteps(maxSteps) {}
+
+  int Advance(float frameTime) {
+    accumulator += frameTime;
+
+    int steps = 0;
+    while (accumulator >= step && steps < maxSteps) {
+      accumulator -= step;
+      steps++;
+    }
+
+    if (steps == maxSteps && accumulator >= step) {
+      accumulator = 0.0f;
+    }
+
+    return steps;
+  }
+
+  float Step() const { return step; }
+  float Alpha() const { return accumulator / step; }
+private:
+  float step;
+  int maxSteps;
+  float accumulator = 0.0f;
+};
+
+}
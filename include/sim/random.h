@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+namespace sim {
+
+/// @brief Small seeded PRNG (xorshift64*) used in place of raylib's
+/// GetRandomValue, so a run is fully reproducible from its seed.
+class Random {
+public:
+  explicit Random(uint64_t seed = 1) { Seed(seed); }
+
+  void Seed(uint64_t seed) {
+    // splitmix64 scramble, xorshift must never start from a zero state
+    seed += 0x9E3779B97F4A7C15ull;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+    state = (seed ^ (seed >> 31)) | 1;
+  }
+
+  uint64_t Next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+  }
+
+  /// @brief Same contract as GetRandomValue: inclusive on both ends.
+  int Range(int min, int max) {
+    if (max < min) { int tmp = max; max = min; min = tmp; }
+    uint64_t span = (uint64_t)((int64_t)max - min) + 1;
+    return (int)(min + (int64_t)(Next() % span));
+  }
+
+  /// @brief Uniform float in [0, 1)
+  float Float() {
+    return (float)(Next() >> 40) / (float)(1 << 24);
+  }
+
+  uint64_t GetState() const { return state; }
+  void SetState(uint64_t value) { state = value; }
+private:
+  uint64_t state;
+};
+
+}
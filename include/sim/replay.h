@@ -0,0 +1,110 @@
+#pragma once
+#include "sim/simulation.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+const uint32_t REPLAY_MAGIC = 0x50524254; // "TBRP"
+// 2 added press sub-ticks, 3 hashes the quantized tower, 4 stores each
+// record's length so readers can step over versions they do not know
+const uint8_t REPLAY_VERSION = 4;
+
+/// @brief One run as an input log: the seed plus the tick and sub-tick of
+/// every handled press. The final tick, score and tower hash let playback
+/// verify the result.
+struct ReplayRun {
+  uint64_t seed = 0;
+  uint32_t tickRate = 0;
+  std::vector<uint64_t> pressTicks;
+  std::vector<uint8_t> pressSubTicks;
+  uint64_t finalTick = 0;
+  uint64_t score = 0;
+  uint64_t towerHash = 0;
+};
+
+/// @brief FNV-1a over the exact bits of every placed block, as stored.
+uint64_t HashTower(const Simulation& simulation);
+
+/// @brief Builds a ReplayRun while a run is being played.
+class ReplayRecorder {
+public:
+  void Begin(uint64_t seed, uint32_t tickRate);
+  void RecordPress(uint64_t tick, uint8_t subTick) {
+    run.pressTicks.push_back(tick);
+    run.pressSubTicks.push_back(subTick);
+  }
+  const ReplayRun& Finish(const Simulation& simulation);
+  /// @brief The run recorded so far
+  const ReplayRun& Current() const { return run; }
+private:
+  ReplayRun run;
+};
+
+/// @brief Appends runs to a replay file through an in-memory buffer.
+///
+/// Records are self-contained, so any number of runs can share a file. Each
+/// starts with the magic, the version and its length. Press ticks are stored
+/// as LEB128 varint deltas, usually one or two bytes each, followed by the
+/// press's sub-tick byte.
+class ReplayWriter {
+public:
+  ~ReplayWriter() { Close(); }
+
+  bool Open(const char *path);
+  void Write(const ReplayRun& run);
+  void Flush();
+  void Close();
+private:
+  FILE *file = nullptr;
+  std::vector<uint8_t> buffer;
+  std::vector<uint8_t> record; // The record being encoded, its length goes first
+};
+
+/// @brief Reads back every run stored in a replay file.
+///
+/// Version 3 runs are read like current ones, they still reproduce. Older
+/// runs were recorded by a simulation that no longer exists and newer ones
+/// may not parse; both are stepped over and counted in Skipped().
+class ReplayReader {
+public:
+  bool Open(const char *path);
+  /// @brief False at the end of the file, or at a record it cannot read:
+  /// Error() tells the two apart
+  bool Next(ReplayRun& run);
+  /// @brief Why Next() stopped early, nullptr at a clean end of file
+  const char *Error() const { return error; }
+  size_t Skipped() const { return skipped; }
+private:
+  std::vector<uint8_t> data;
+  size_t cursor = 0;
+  size_t skipped = 0;
+  const char *error = nullptr;
+
+  bool Fail(const char *reason) { error = reason; return false; }
+  bool ReadRun(size_t end, bool subTicks, ReplayRun& run);
+};
+
+/// @brief Drives a Simulation from a ReplayRun, as fast as the CPU allows.
+class ReplayPlayer {
+public:
+  explicit ReplayPlayer(Simulation& simulation): simulation(simulation) {}
+
+  void Start(const ReplayRun& run);
+  /// @brief Runs up to maxTicks steps, returns false once the run is over
+  bool Advance(uint64_t maxTicks);
+  bool Finished() const;
+
+  /// @brief Re-simulates the whole run with no rendering
+  void FastForward(const ReplayRun& run);
+  /// @brief Re-simulates the run and checks the tower matches the recording
+  bool Verify(const ReplayRun& run);
+private:
+  Simulation& simulation;
+  const ReplayRun *run = nullptr;
+  size_t nextPress = 0;
+};
+
+}
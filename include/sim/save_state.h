@@ -0,0 +1,169 @@
+#pragma once
+#include "sim/simulation.h"
+#include "util/mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace sim {
+
+const uint32_t SAVE_MAGIC = 0x56534254; // "TBSV"
+const uint16_t SAVE_VERSION = 1;
+const uint32_t SAVE_ENDIAN_MARK = 0x01020304; // Reads back scrambled on the other endianness
+
+/// @brief Sections of a save file. Each holds an array of one fixed-size
+/// record type; the simulation writes the first ones, the layers above it add
+/// their own.
+enum SaveSectionId : uint32_t {
+  SAVE_SIMULATION = 1, // SavedSimulation
+  SAVE_TOWER,          // entity::PackedBlock per settled block, bottom to top
+  SAVE_MOVEMENTS,      // SavedMovement
+  SAVE_DEBRIS,         // entity::DebrisPool::Piece, sleepers first
+  SAVE_SESSION,        // SavedSession, written by SimulationThread
+  SAVE_REPLAY,         // SavedPress per press of the run so far
+  SAVE_UI              // Written by ui::UIManager
+};
+
+struct SaveHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;   // sizeof(SaveHeader)
+  uint32_t endianMark;
+  uint32_t sectionCount;
+  uint64_t fileSize;
+  uint64_t tableOffset;  // SaveSection[sectionCount]
+  uint64_t checksum;     // SaveChecksum of everything after the header
+};
+
+struct SaveSection {
+  uint32_t id;
+  uint32_t recordSize;   // Checked against the reader's record type
+  uint64_t offset;       // 8 byte aligned
+  uint64_t count;
+};
+
+struct SavedBlock {
+  uint64_t index;
+  Vector3 position;
+  Vector3 size;
+  math::Color color;
+  int32_t colorOffset;
+};
+
+struct SavedSimulation {
+  uint32_t state;
+  uint32_t reserved;
+  uint64_t seed;
+  uint64_t tick;
+  uint64_t random;          // Random::GetState
+  uint64_t towerSize;       // Settled blocks plus the top one
+  SavedBlock top;
+  SavedBlock current;
+  Vector3 currentLastPosition;
+  float baseSpeed;
+  float speedPerBlock;
+  float perfectThreshold;
+  float debrisGravity;
+  uint64_t debrisSleeping;
+};
+
+struct SavedMovement {
+  uint32_t owner;
+  uint32_t direction;
+  uint32_t axis;
+  float speed;
+  float threshold;
+  float phase;
+};
+
+struct SavedSession {
+  float cameraY;
+  float previousCameraY;
+  float cameraTargetY;
+  float previousCameraTargetY;
+};
+
+struct SavedPress {
+  uint64_t tick;
+  uint32_t subTick;
+  uint32_t reserved;
+};
+
+/// @brief 64 bit words folded FNV-1a style. Catches truncation and stray
+/// writes at memory speed; it is no defence against deliberate edits.
+uint64_t SaveChecksum(const uint8_t *data, size_t size);
+
+/// @brief Builds a save file in memory and writes it with a single fwrite.
+///
+/// Records are stored in their in-memory layout, so a file only loads on the
+/// platform and layout it was written with: the header's endian mark and each
+/// section's record size are checked for that. The buffer keeps its capacity
+/// between saves.
+class SaveWriter {
+public:
+  void Begin();
+
+  template <typename T>
+  void Add(uint32_t id, const T *records, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "save records are copied as bytes");
+    AddBytes(id, records, sizeof(T), count);
+  }
+
+  template <typename T>
+  void Add(uint32_t id, const T& record) { Add(id, &record, 1); }
+
+  /// @brief Appends the section table, fills in the header and writes it all
+  bool WriteFile(const char *path);
+
+  size_t Size() const { return buffer.size(); }
+private:
+  std::vector<uint8_t> buffer;
+  std::vector<SaveSection> sections;
+
+  void AddBytes(uint32_t id, const void *records, size_t recordSize, size_t count);
+};
+
+/// @brief Reads a save file through a memory mapping.
+///
+/// Open() checks the header, every section's bounds and alignment and the
+/// checksum without copying anything; Get() then hands out pointers straight
+/// into the mapping, valid until the reader goes away.
+class SaveReader {
+public:
+  bool Open(const char *path);
+  const char *Error() const { return error; }
+
+  /// @brief Records of section id, nullptr if it is missing or holds another type
+  template <typename T>
+  const T *Get(uint32_t id, size_t& count) const {
+    return (const T *)Find(id, sizeof(T), count);
+  }
+
+  /// @brief Section id as a single record
+  template <typename T>
+  bool Get(uint32_t id, T& record) const {
+    size_t count;
+    const T *records = Get<T>(id, count);
+    if (!records || count != 1) return false;
+    record = records[0];
+    return true;
+  }
+private:
+  util::MappedFile file;
+  const SaveSection *table = nullptr;
+  uint32_t sectionCount = 0;
+  const char *error = "not open";
+
+  bool Validate();
+  const void *Find(uint32_t id, size_t recordSize, size_t& count) const;
+};
+
+/// @brief Adds the simulation's sections. Colliders are not stored, debris
+/// lands on the loaded tower directly and the terrain is put back on load.
+void SaveSimulation(SaveWriter& writer, const Simulation& simulation);
+/// @brief Restores a simulation saved by SaveSimulation. Everything is checked
+/// before anything is touched, on failure the simulation is left as it was.
+bool LoadSimulation(const SaveReader& reader, Simulation& simulation);
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "sim/fixed_timestep.h"
+#include "sim/replay.h"
+#include "sim/save_state.h"
+#include "sim/simulation.h"
+#include "sim/snapshot.h"
+#include "sim/stress.h"
+#include "util/spsc_queue.h"
+#include "util/triple_buffer.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace sim {
+
+const size_t INPUT_QUEUE_SIZE = 64;
+const int MAX_PENDING_PRESSES = 8;
+
+/// @brief Seconds on the steady clock both threads stamp and step against.
+double Clock();
+
+/// @brief Runs the Simulation on its own thread at SIMULATION_STEP.
+///
+/// The render thread pushes timestamped presses through a lock-free queue and
+/// reads the latest FrameSnapshot from a triple buffer, so neither side ever
+/// blocks the other: a stalled GPU frame no longer delays steps, and a long
+/// step no longer delays a frame. Replay recording and the camera follow live
+/// here too since both advance per step.
+class SimulationThread {
+public:
+  SimulationThread();
+  ~SimulationThread() { Stop(); }
+
+  /// @brief Before Start: every run begins on a prebuilt tower under a steady
+  /// debris storm. Such runs cannot be replayed, nothing gets recorded.
+  void SetStress(const StressSettings& settings);
+  void Start(const char *replayPath);
+  void Stop();
+
+  /// @brief While stopped: adds the run in progress, its press log and the
+  /// camera to writer
+  void Save(SaveWriter& writer) const;
+  /// @brief Before Start: the next Start resumes the saved run instead of
+  /// beginning a fresh one. False if the file holds no usable run.
+  bool Load(const SaveReader& reader);
+  /// @brief While stopped: the state the run was left in. The snapshot can
+  /// lag behind it by the steps taken since the last Acquire.
+  GameState State() const { return simulation.state; }
+
+  /// @brief Render side: a press seen at time (Clock())
+  void PushPress(double time) { input.Push(time); }
+  /// @brief Render side: the tower mirror fell behind the snapshots' recent
+  /// blocks, the next snapshot carries a towerCopy of the whole tower
+  void RequestTowerCopy() { towerCopyRequested.store(true); }
+
+  /// @brief Render side: latest snapshot, true when it changed
+  bool AcquireSnapshot() { return snapshots.Acquire(); }
+  const FrameSnapshot& Snapshot() const { return snapshots.Front(); }
+private:
+  Simulation simulation;
+  ReplayRecorder replayRecorder;
+  ReplayWriter replayWriter;
+  Random seeds;
+  StressSettings stress;
+  DebrisStorm debrisStorm;
+  std::shared_ptr<const entity::TowerStore> towerCopy; // Never changes once published
+
+  util::SpscQueue<double, INPUT_QUEUE_SIZE> input;
+  util::TripleBuffer<FrameSnapshot> snapshots;
+  std::thread thread;
+  std::atomic<bool> running{false};
+  std::atomic<bool> towerCopyRequested{false};
+
+  // Only touched by the simulation thread
+  double pressTimes[MAX_PENDING_PRESSES];
+  int pendingPresses = 0;
+  uint32_t generation = 0;
+  uint64_t perfectCount = 0;
+  bool resumed = false; // Start() keeps the loaded run
+  float cameraY = 50.0f;
+  float previousCameraY = 50.0f;
+  float cameraTargetY = 0.0f;
+  float previousCameraTargetY = 0.0f;
+
+  void Run();
+  void Restart();
+  Input TakeInput(float dt, double stepEnd);
+  void Step(float dt, double stepEnd);
+  void Publish(double stepTime);
+};
+
+}
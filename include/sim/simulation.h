@@ -0,0 +1,101 @@
+#pragma once
+#include "entity/block.h"
+#include "entity/component_store.h"
+#include "entity/debris_pool.h"
+#include "entity/layer_hash.h"
+#include "entity/movement.h"
+#include "entity/tower_store.h"
+#include "sim/random.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// CONSTANTS
+const int MOVEMENT_THRESHOLD = 16;
+const float MIN_OVERLAY = 0.1f;
+const int SUB_TICKS = 256; // Resolution of a press inside one step
+const Vector3 TERRAIN_POSITION = { 0, -2, 0 };
+const Vector3 TERRAIN_SIZE = { 50, 4, 50 };
+
+/// @brief Balancing knobs, exposed so tools can sweep them headlessly.
+struct Tuning {
+  float baseSpeed = 16.0f;        // Speed of the first moving block
+  float speedPerBlock = 0.5f;     // Added for every block in the tower
+  float perfectThreshold = 0.3f;  // Max offset that still snaps as PERFECT
+};
+
+typedef enum {
+  READY_STATE,
+  PLAYING_STATE,
+  GAME_OVER_STATE
+} GameState;
+
+/// @brief Everything the player can do during one step.
+struct Input {
+  bool press = false;
+  uint8_t subTick = 0; // When the press happened, in 1/SUB_TICKS of the step
+
+  /// @brief Quantizes a press offset (seconds into a step of length dt)
+  static uint8_t SubTickFor(double offset, double dt) {
+    double fraction = offset / dt * SUB_TICKS;
+    if (fraction <= 0.0) return 0;
+    return fraction >= SUB_TICKS - 1 ? SUB_TICKS - 1 : (uint8_t)(fraction + 0.5);
+  }
+};
+
+/// @brief What happened during one step, the caller turns these into feedback.
+struct StepEvents {
+  bool started = false;
+  bool placed = false;
+  bool perfect = false;
+  bool gameOver = false;
+  bool restartRequested = false;
+};
+
+/// @brief The whole game rules with no window, input device or GPU behind it.
+///
+/// Input arrives as explicit events, randomness comes from a seeded PRNG and
+/// time only moves through Step(dt), so a run is reproducible from its seed and
+/// its inputs. Only raylib's plain types and header-only raymath are used here.
+class Simulation {
+public:
+  GameState state = READY_STATE;
+  uint64_t seed = 0;
+  uint64_t tick = 0;  // Steps taken since Reset
+  entity::TowerStore placed_blocks;
+  entity::Block current_block;
+  Vector3 current_block_last_position = { 0, 0, 0 }; // Position one step ago, for interpolation
+  entity::ComponentStore<entity::Movement> movements;
+  entity::DebrisPool debris;
+  entity::LayerHash colliders; // Terrain, debris lands on it and on placed_blocks
+  Random random;
+  Tuning tuning;
+
+  explicit Simulation(uint64_t seed = 1);
+
+  void Reset(uint64_t seed);
+  StepEvents Step(const Input& input, float dt);
+
+  /// @brief Action methods
+  entity::Block CreateMovingBlock();
+  /// @brief pressOffset is the time since the start of the step, the block is
+  /// cut where it was at that moment rather than where the last step left it
+  void PlaceBlock(StepEvents& events, float pressOffset = 0.0f);
+  void CreateFallingBlock(Vector3 position, Vector3 size, math::Color color);
+  /// @brief Refills the colliders that are not tower blocks, i.e. the terrain
+  void RebuildColliders();
+  entity::Block& GetPreviousBlock() { return placed_blocks.Top(); }
+  const entity::Block& GetPreviousBlock() const { return placed_blocks.Top(); }
+  entity::Movement *GetCurrentMovement() { return movements.Get(current_block.Id()); }
+  const entity::Movement *GetCurrentMovement() const { return movements.Get(current_block.Id()); }
+
+  size_t Score() const { return placed_blocks.Size() - 1; }
+private:
+  /// @brief Update methods
+  void UpdateGameState(const Input& input, float dt, StepEvents& events);
+  void UpdateCurrentBlock(float dt);
+  void UpdateFallingBlocks(float dt);
+};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "entity/block.h"
+#include "sim/simulation.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sim {
+
+// Placed blocks carried per snapshot. The render side only needs the ones it
+// has not seen yet, and each placement takes a press, so a frame rarely
+// misses more than a handful. After a longer stall it asks for a towerCopy.
+const size_t SNAPSHOT_RECENT_BLOCKS = 64;
+
+struct DebrisInstance {
+  Vector3 position;
+  Vector3 lastPosition;
+  Vector3 rotation;
+  Vector3 lastRotation;
+  Vector3 size;
+  math::Color color;
+};
+
+/// @brief Everything the renderer needs from one simulation step, copied out
+/// so the simulation can keep running while it is drawn.
+struct FrameSnapshot {
+  uint64_t tick = 0;
+  double stepTime = 0.0;     // Clock() time the end of this step stands for
+  uint32_t generation = 0;   // Bumped on every restart
+  GameState state = READY_STATE;
+  size_t score = 0;
+  uint64_t perfectCount = 0; // Running total, the renderer diffs it for effects
+
+  // placed_blocks[placedCount - recentCount, placedCount)
+  size_t placedCount = 0;
+  size_t recentCount = 0;
+  entity::Block recent[SNAPSHOT_RECENT_BLOCKS];
+  // Read-only copy of the tower, for blocks recent does not reach: the
+  // prebuilt stress tower, a loaded one, or one the render side asked for
+  std::shared_ptr<const entity::TowerStore> towerCopy;
+
+  entity::Block current;
+  Vector3 currentLastPosition = { 0, 0, 0 };
+
+  std::vector<DebrisInstance> debris; // Reserved up front, never reallocates
+
+  float cameraY = 0.0f;
+  float previousCameraY = 0.0f;
+  float cameraTargetY = 0.0f;
+  float previousCameraTargetY = 0.0f;
+};
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "sim/simulation.h"
+#include <cstddef>
+
+namespace sim {
+
+/// @brief Synthetic load for scaling tests, see --stress in main.cpp.
+struct StressSettings {
+  bool enabled = false;
+  size_t towerHeight = 10000;                            // Blocks placed before the first step
+  float debrisPerSecond = 100.0f;                        // Pieces chopped off around the tower top
+  float perfectsPerSecond = 10.0f;                       // PERFECT messages, fired by the renderer
+  size_t debrisCapacity = entity::DEBRIS_POOL_CAPACITY;
+  float seconds = 30.0f;                                 // Then the game quits and reports
+};
+
+/// @brief Places the moving block exactly on the one below it, which never
+/// chops anything off and never ends the run
+void PlacePerfect(Simulation& simulation);
+
+/// @brief Starts the run if it has not started yet, then places perfect
+/// blocks until the tower is height blocks tall
+void BuildTower(Simulation& simulation, size_t height);
+
+/// @brief Chops pieces off around the tower top through CreateFallingBlock,
+/// at a steady rate however the steps fall.
+class DebrisStorm {
+public:
+  explicit DebrisStorm(float perSecond = 0.0f): perSecond(perSecond) {}
+
+  void Update(Simulation& simulation, float dt);
+private:
+  float perSecond;
+  float credit = 0.0f; // Pieces owed, carried over between steps
+};
+
+}
@@ -0,0 +1,57 @@
+#ifndef UI_MESSAGE_POOL_H
+#define UI_MESSAGE_POOL_H
+
+#include "raylib.h"
+#include <cstddef>
+
+namespace ui
+{
+
+const size_t MAX_UI_MESSAGES = 32;
+const size_t MAX_MESSAGE_LENGTH = 24; // Including the terminator
+
+enum class UIAnimType { NONE, WIGGLE, POP_IN, FLOAT_UP };
+
+struct TextElement {
+    char text[MAX_MESSAGE_LENGTH]; // Stored inline, no heap string
+    Vector2 position;
+    float fontSize;
+    Color color;
+    float lifetime;
+    float maxLifetime;
+    UIAnimType anim;
+    float delay; // Used for sequential letter pops
+    bool useBloom; // New flag for shader
+};
+
+/// @brief Fixed ring of on-screen messages.
+///
+/// Messages are kept in spawn order, so with equal lifetimes the oldest one is
+/// always the next to expire and is popped from the head. Spawning into a
+/// full ring overwrites the oldest message. Nothing here ever allocates.
+class MessagePool {
+public:
+    /// @brief Claims a slot and copies the text in, truncating if needed
+    TextElement& Spawn(const char *text);
+    void Update(float dt);
+    void Clear() { head = 0; count = 0; }
+
+    size_t Count() const { return count; }
+
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        for (size_t i = 0; i < count; i++) {
+            const TextElement& element = slots[(head + i) % MAX_UI_MESSAGES];
+            // Shorter-lived messages can expire behind an older one
+            if (element.lifetime > 0) visit(element);
+        }
+    }
+private:
+    TextElement slots[MAX_UI_MESSAGES];
+    size_t head = 0;
+    size_t count = 0;
+};
+
+}
+
+#endif
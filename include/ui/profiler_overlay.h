@@ -0,0 +1,33 @@
+#ifndef UI_PROFILER_OVERLAY_H
+#define UI_PROFILER_OVERLAY_H
+
+#include "raylib.h"
+#include "render/command_buffer.h"
+#include "util/profiler.h"
+
+namespace ui
+{
+
+const size_t PROFILER_GRAPH_FRAMES = 240;
+const size_t PROFILER_PERCENTILE_WINDOW = 60;
+
+/// @brief Debug overlay (toggled with F3) showing rolling p50/p95/p99 frame
+/// times, per-phase percentiles over the profiler history and what the last
+/// command buffer submit cost.
+class ProfilerOverlay {
+public:
+    void HandleInput();
+    void Draw(int x, int y, const render::RenderStats& stats);
+
+    bool visible = false;
+private:
+    util::FrameRecord records[util::PROFILER_HISTORY];
+    float scratch[util::PROFILER_HISTORY];
+    float graph[3][PROFILER_GRAPH_FRAMES]; // Rolling p50, p95, p99
+
+    float Percentile(size_t count, float p);
+};
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef UI_TEXT_RENDERER_H
+#define UI_TEXT_RENDERER_H
+
+#include "raylib.h"
+#include "util/frame_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ui
+{
+
+struct GlyphQuad {
+    Rectangle source; // Region of the font atlas
+    Rectangle dest;   // Relative to the layout origin
+    int charIndex;    // Position in the source string, spaces get no quad
+};
+
+/// @brief Positioned glyphs for one string at one size, built once and reused.
+struct TextLayout {
+    std::vector<GlyphQuad> glyphs;
+    float width = 0.0f;
+    int fontSize = 0;
+};
+
+/// @brief Draws HUD text from the font atlas as one batch of textured quads.
+///
+/// Layouts are cached by string and size, so steady-state frames do no text
+/// shaping or MeasureText calls. The cache evicts the least recently used
+/// layout, so a reference from Layout() stays valid until MAX_CACHED_LAYOUTS
+/// other strings have been looked up. Draw() only queues quads, into the frame
+/// arena; Flush() submits everything queued since Begin() with a single
+/// texture bind.
+class TextRenderer {
+public:
+    /// @brief Uses raylib's default font atlas, loaded with the window
+    void Load();
+
+    /// @brief fixedAdvance > 0 places glyph i at i * fixedAdvance instead of
+    /// using the font's advances
+    const TextLayout& Layout(const char *text, int fontSize, float fixedAdvance = 0.0f);
+    /// @brief Rebuilds a caller-owned layout in place, for text that changes
+    void BuildLayout(TextLayout& layout, const char *text, int fontSize, float fixedAdvance = 0.0f) const;
+
+    void Begin();
+    void Draw(const TextLayout& layout, Vector2 position, Color color, const float *glyphOffsetsY = nullptr);
+    void Flush();
+
+    size_t QueuedGlyphs() const { return batch.size(); }
+private:
+    struct QueuedQuad {
+        Rectangle source;
+        Rectangle dest;
+        Color color;
+    };
+
+    struct CachedLayout {
+        std::string text;
+        int fontSize;
+        float fixedAdvance;
+        uint64_t hash;
+        TextLayout layout;
+    };
+
+    Font font = {};
+    // Most recently used first; list nodes never move, so handed out
+    // references survive hits and other evictions
+    std::list<CachedLayout> cache;
+    std::unordered_multimap<uint64_t, std::list<CachedLayout>::iterator> cacheIndex;
+    util::ArenaVector<QueuedQuad> batch;
+    size_t lastBatchSize = 0;
+};
+
+}
+
+#endif
@@ -2,58 +2,92 @@
 #define UI_MANAGER_H
 
 #include "raylib.h"
-#include <vector>
-#include <string>
+#include "render/background_renderer.h"
+#include "render/command_buffer.h"
+#include "render/material.h"
+#include "render/resource_cache.h"
+#include "render/scaled_target.h"
+#include "sim/save_state.h"
+#include "ui/text_renderer.h"
+#include "ui/message_pool.h"
+#include <cstdint>
 
 namespace ui
 {
 
 enum class UIState { START, PLAYING, GAME_OVER };
 
-enum class UIAnimType { NONE, WIGGLE, POP_IN, FLOAT_UP };
-
-struct TextElement {
-    std::string text;
-    Vector2 position;
-    float fontSize;
-    Color color;
-    float lifetime;
-    float maxLifetime;
-    UIAnimType anim;
-    float delay; // Used for sequential letter pops
-    bool useBloom; // New flag for shader
+/// @brief The sim::SAVE_UI record: live messages oldest first. The state and
+/// score are not in it, they follow the simulation's snapshot.
+struct SavedUI {
+  float effectTimer;
+  uint32_t messageCount;
+  TextElement messages[MAX_UI_MESSAGES];
 };
 
 class UIManager {
 private:
   UIState currentState = UIState::START;
+  render::RenderTextureHandle canvasHandle;
   RenderTexture2D canvas;
-  Shader uiShader;
-  std::vector<TextElement> elements;
+  render::PostMaterial postMaterial;
+  render::CompositeMaterial compositeMaterial;
+  // The post pass can run below window resolution, see SetResolutionScale
+  render::ScaledTarget postTarget{"ui_post"};
+  float resolutionScale = 1.0f;
+  // Set for merged composites, see SetBackdrop
+  const render::BackgroundRenderer *backdrop = nullptr;
+  Texture2D scene = {};
+
+  // The canvas is only redrawn when what is on it changes: the score, the
+  // state's overlay, or messages being alive (they animate every frame)
+  bool canvasDirty = true;
+  size_t score = 0;
+  MessagePool messages;
+  TextRenderer text;
+
+  // The score string only changes on placement, its layout is rebuilt then
+  TextLayout scoreLayout;
+  size_t scoreLayoutValue = SIZE_MAX;
   
-  // Shader locations
-  int intensityLoc;
-  int timeLoc;
   float effectTimer = 0.0f;
 
+  void DrawOverlay(const char *title, const char *subtitle, int titleSize, int subtitleSize, int titleY, int subtitleY);
   void DrawStartOverlay();
   void DrawGameOverOverlay();
+  void Composite();
+  void CompositeMerged();
 public:
   UIManager();
   ~UIManager();
 
   void Update(float dt);
-  void BeginUI();
+  /// @brief Returns false when the canvas still shows this frame's HUD, the
+  /// draws and EndUI are then skipped
+  bool BeginUI();
   void EndUI();
-  void Render();
+  /// @brief Records the post pass that composites the canvas over the scene
+  void Render(render::CommandBuffer& commands);
+
+  void SetState(UIState newState);
+  void SetScore(size_t newScore);
+  /// @brief Internal resolution of the post pass, clamped so text stays legible
+  void SetResolutionScale(float scale);
+  /// @brief Merged composite: with a background the post pass also draws it
+  /// and scene (the 3D pass rendered offscreen) under the UI, all in one
+  /// full-screen pass at window resolution. nullptr goes back to separate passes.
+  void SetBackdrop(const render::BackgroundRenderer *background, Texture2D scene);
 
-  void SetState(UIState newState) { currentState = newState; };
+  void Save(sim::SaveWriter& writer) const;
+  /// @brief Puts back the messages of a save, false if it has none
+  bool Load(const sim::SaveReader& reader);
   
-  void DrawScore(size_t score);
+  void DrawScore();
   void DrawActiveOverlay();
+  void DrawMessages();
   void SpawnPerfect();
   void SpawnClose();
-  void SpawnMessage(std::string text, Vector2 pos, Color color, bool isBloom, UIAnimType anim = UIAnimType::FLOAT_UP);
+  void SpawnMessage(const char *text, Vector2 pos, Color color, bool isBloom, UIAnimType anim = UIAnimType::FLOAT_UP);
   void TriggerPulse() { effectTimer = 1.0f; }
 };
 
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+const size_t FRAME_ARENA_CAPACITY = 1 << 20; // Grows on its own if a frame needs more
+
+/// @brief Bump allocator for data that lives until the end of the frame.
+///
+/// Allocate() only moves an offset forward and Reset(), called at the top of
+/// every main loop iteration, takes it back to zero; nothing is freed one by
+/// one. A frame that runs out of room falls back to the heap for the rest of
+/// it, and the next Reset() regrows the block to fit, so once the load stops
+/// growing frames allocate nothing from the heap. Main thread only.
+class FrameArena {
+public:
+  static FrameArena& Instance();
+
+  explicit FrameArena(size_t capacity = FRAME_ARENA_CAPACITY);
+  ~FrameArena();
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  void *Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+  template <typename T>
+  T *AllocateArray(size_t count) { return (T *)Allocate(count * sizeof(T), alignof(T)); }
+
+  /// @brief printf into the arena, the string stays valid until the next Reset
+  const char *Format(const char *format, ...);
+
+  /// @brief Invalidates everything allocated since the previous call
+  void Reset();
+
+  size_t Used() const { return offset + overflowBytes; }
+  size_t Capacity() const { return capacity; }
+  size_t Peak() const { return peak; }           // Largest Used() of any frame
+  size_t Overflows() const { return overflows; } // Heap fallbacks since startup
+private:
+  struct OverflowBlock {
+    OverflowBlock *next;
+  };
+
+  uint8_t *base = nullptr;
+  size_t capacity = 0;
+  size_t offset = 0;
+  size_t overflowBytes = 0;
+  size_t peak = 0;
+  size_t overflows = 0;
+  OverflowBlock *overflow = nullptr;
+
+  void FreeOverflow();
+};
+
+/// @brief Standard allocator over a FrameArena, deallocation is a no-op.
+template <typename T>
+class ArenaAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator(FrameArena& arena = FrameArena::Instance()) noexcept: arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept: arena(other.arena) {}
+
+  T *allocate(size_t count) { return arena->AllocateArray<T>(count); }
+  void deallocate(T *, size_t) noexcept {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+  FrameArena *arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/// @brief Starts a frame for a vector kept across frames: its old storage went
+/// with the last Reset, so it is dropped unread and capacity is reserved anew.
+template <typename T>
+void Renew(ArenaVector<T>& vector, size_t capacity) {
+  static_assert(std::is_trivially_destructible<T>::value, "arena storage is dropped without destructors");
+  ArenaVector<T> fresh(vector.get_allocator());
+  fresh.reserve(capacity);
+  vector.swap(fresh);
+}
+
+}
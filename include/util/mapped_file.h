@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace util {
+
+/// @brief Read-only memory mapping of a whole file. Pages are only read in
+/// when touched, so opening is O(1) whatever the size. The file cannot be
+/// empty.
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(const char *path);
+  void Close();
+
+  const uint8_t *Data() const { return data; }
+  size_t Size() const { return size; }
+private:
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  void *mapping = nullptr; // Windows only, the file mapping object
+};
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+
+namespace util {
+
+/// @brief Largest resident set of the process so far in bytes, 0 when the
+/// platform does not report it.
+///
+/// Lives in its own translation unit: windows.h and raylib.h declare
+/// conflicting names and cannot be included together.
+size_t PeakResidentBytes();
+
+}
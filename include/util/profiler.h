@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace util {
+
+enum ProfilePhase {
+  PHASE_FRAME,       // Whole main loop iteration
+  PHASE_UPDATE,      // Every Game::Update of the frame
+  PHASE_SIM_STEP,    // sim::Simulation::Step
+  PHASE_CAMERA,      // Camera follow
+  PHASE_UI_UPDATE,   // UIManager::Update
+  PHASE_BACKGROUND,  // Balatro background pass
+  PHASE_RENDER_3D,   // Game::Render3D and the submit of its pass
+  PHASE_UI_BEGIN,    // UIManager::BeginUI
+  PHASE_UI_DRAW,     // HUD draw calls between BeginUI and EndUI
+  PHASE_UI_END,      // UIManager::EndUI (glyph batch flush)
+  PHASE_UI_RENDER,   // UIManager::Render (post shader composite)
+  PHASE_PRESENT,     // EndDrawing: batch flush, swap and frame pacing
+  PHASE_COUNT
+};
+
+const char *PhaseName(ProfilePhase phase);
+
+/// @brief Milliseconds spent in each phase during one frame. Phases that run
+/// several times per frame (simulation steps) are summed.
+struct FrameRecord {
+  uint64_t frame;
+  float ms[PHASE_COUNT];
+};
+
+const size_t PROFILER_HISTORY = 1024; // Power of two
+
+/// @brief Collects per-phase timings into a ring of frame records.
+///
+/// Scopes accumulate into atomic per-phase counters, so timing code can run
+/// on any thread without a lock. EndFrame() publishes the totals into the
+/// ring; every slot carries a sequence number (a seqlock) so readers copying
+/// history while the frame thread writes never see a torn record.
+class Profiler {
+public:
+  static Profiler& Instance();
+
+  void SetEnabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+  bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+  void Add(ProfilePhase phase, uint64_t nanoseconds) {
+    pending[phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+  }
+
+  /// @brief Publishes everything added since the previous call as one frame
+  void EndFrame();
+
+  /// @brief Copies up to maxRecords of the most recent frames, oldest first
+  size_t Snapshot(FrameRecord *out, size_t maxRecords) const;
+  uint64_t FrameCount() const { return head.load(std::memory_order_acquire); }
+
+  /// @brief Dumps the whole history as CSV, one row per frame
+  bool WriteCsv(const char *path) const;
+private:
+  struct Slot {
+    std::atomic<uint32_t> sequence{0};
+    FrameRecord record;
+  };
+
+  std::atomic<bool> enabled{true};
+  std::atomic<uint64_t> pending[PHASE_COUNT] = {};
+  std::atomic<uint64_t> head{0};
+  Slot slots[PROFILER_HISTORY];
+};
+
+/// @brief Times its own lifetime into a phase
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfilePhase phase): phase(phase), start(std::chrono::steady_clock::now()) {}
+  ~ProfileScope() {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    Profiler::Instance().Add(phase, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+private:
+  ProfilePhase phase;
+  std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef DISABLE_PROFILER
+#define PROFILE_SCOPE(phase) util::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+#else
+#define PROFILE_SCOPE(phase) ((void)0)
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace util {
+
+/// @brief Bounded lock-free queue for exactly one producer and one consumer
+/// thread. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+public:
+  /// @brief Producer side, false when full
+  bool Push(const T& value) {
+    size_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - head.load(std::memory_order_acquire) == Capacity) return false;
+
+    items[tail & (Capacity - 1)] = value;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Consumer side, false when empty
+  bool Pop(T& value) {
+    size_t head = this->head.load(std::memory_order_relaxed);
+    if (head == tail.load(std::memory_order_acquire)) return false;
+
+    value = items[head & (Capacity - 1)];
+    this->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+private:
+  T items[Capacity];
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+}
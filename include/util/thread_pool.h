@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+/// @brief Fixed set of worker threads with one task deque each.
+///
+/// Workers pop from the back of their own deque and, when it runs dry, steal
+/// from the front of the others, so uneven tasks (a bot that survives for
+/// thousands of blocks next to one that dies at 3) still keep every core busy.
+class ThreadPool {
+public:
+  typedef std::function<void()> Task;
+
+  /// @brief threadCount 0 uses every hardware thread
+  explicit ThreadPool(size_t threadCount = 0);
+  ~ThreadPool();
+
+  void Submit(Task task);
+  /// @brief Blocks until every submitted task has finished
+  void Wait();
+
+  size_t ThreadCount() const { return workers.size(); }
+private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::atomic<size_t> nextQueue{0};
+  std::atomic<size_t> pending{0};
+  std::atomic<bool> stopping{false};
+
+  std::mutex sleepMutex;
+  std::condition_variable workAvailable;
+  std::condition_variable allDone;
+
+  void WorkerLoop(size_t index);
+  bool PopLocal(size_t index, Task& task);
+  bool Steal(size_t thief, Task& task);
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace util {
+
+/// @brief Lock-free single producer, single consumer hand-off of the latest
+/// value.
+///
+/// The producer fills Back() and publishes it; the consumer picks up the most
+/// recent published slot with Acquire() and reads it through Front() for as
+/// long as it likes. Neither side ever waits: three slots mean the producer
+/// always has one the consumer cannot be reading, and values the consumer was
+/// too slow to see are simply overwritten.
+template <typename T>
+class TripleBuffer {
+public:
+  /// @brief Producer side: the slot to fill next
+  T& Back() { return slots[back]; }
+
+  /// @brief Producer side: makes Back() the latest value
+  void Publish() {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  /// @brief Consumer side: switches Front() to the latest value, false when
+  /// nothing was published since the last call
+  bool Acquire() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /// @brief Consumer side: the value picked up by the last Acquire()
+  const T& Front() const { return slots[front]; }
+private:
+  static constexpr uint8_t INDEX_MASK = 0x3;
+  static constexpr uint8_t FRESH = 0x4;
+
+  T slots[3];
+  // Each side only touches its own index, middle is the only shared one
+  alignas(64) uint8_t back = 0;
+  alignas(64) uint8_t front = 1;
+  alignas(64) std::atomic<uint8_t> middle{2};
+};
+
+}
@@ -1,12 +1,12 @@
 #version 330
 
-uniform vec3 blockColor;
 uniform vec3 cameraPosition;
 
 out vec4 FragColor;
 
 in vec3 FragPosition;
 in vec3 FragNormal;
+in vec3 FragBlockColor;
 
 void main() {
   vec3 lightPosition = vec3(-50, 500, -50);
@@ -32,5 +32,5 @@ void main() {
   float spec = pow(max(dot(viewDirection, reflectDirection), 0), 32);
   vec3 specular = spec * lightSpecular * blockSpecular;
 
-  FragColor = vec4((ambient + diffuse + specular) * blockColor, 1.0);
+  FragColor = vec4((ambient + diffuse + specular) * FragBlockColor, 1.0);
 }
@@ -0,0 +1,26 @@
+#version 330
+
+uniform mat4 mvp;
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in mat4 instanceTransform;
+
+out vec3 FragPosition;
+out vec3 FragNormal;
+out vec3 FragBlockColor;
+
+void main() {
+  // The bottom row of the instance transform carries the block color
+  FragBlockColor = vec3(instanceTransform[0][3], instanceTransform[1][3], instanceTransform[2][3]);
+
+  mat4 matModel = instanceTransform;
+  matModel[0][3] = 0.0;
+  matModel[1][3] = 0.0;
+  matModel[2][3] = 0.0;
+
+  FragPosition = vec3(matModel * vec4(vertexPosition, 1.0));
+  FragNormal = normalize(mat3(matModel) * vertexNormal);
+
+  gl_Position = mvp * matModel * vec4(vertexPosition, 1.0);
+}
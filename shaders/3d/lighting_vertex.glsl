@@ -2,14 +2,19 @@
 
 uniform mat4 mvp;
 uniform mat4 matModel;
+uniform vec3 blockColor;
 
 in vec3 vertexPosition;
 in vec3 vertexNormal;
+in vec4 vertexColor;
 
 out vec3 FragPosition;
 out vec3 FragNormal;
+out vec3 FragBlockColor;
 
 void main() {
+  // Baked tower chunks carry their colors per vertex, blockColor tints them
+  FragBlockColor = blockColor * vertexColor.rgb;
   FragPosition = vec3(matModel * vec4(vertexPosition, 1.0));
   FragNormal = normalize(mat3(matModel) * vertexNormal);
 
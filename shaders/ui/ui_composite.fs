@@ -0,0 +1,61 @@
+#version 330
+
+// Background, 3D scene and UI post effect in a single full-screen pass. All
+// inputs are render textures of the same orientation, so one uv reads them all.
+
+in vec2 fragTexCoord;
+out vec4 finalColor;
+
+uniform sampler2D texture0;    // UI canvas
+uniform sampler2D scene;       // 3D pass, transparent where nothing was drawn
+uniform sampler2D background0; // Background keyframes k and k+1
+uniform sampler2D background1;
+uniform float backgroundBlend;
+uniform float effectIntensity; // Pulse for perfect hits
+
+// Same as ui_post.glsl: chromatic aberration plus bloom over the canvas
+vec4 UIPost(vec2 uv) {
+    if (effectIntensity <= 0.0) return texture(texture0, uv);
+
+    float amount = 0.005 * effectIntensity;
+    vec4 rCol = texture(texture0, vec2(uv.x + amount, uv.y));
+    vec4 gCol = texture(texture0, uv);
+    vec4 bCol = texture(texture0, vec2(uv.x - amount, uv.y));
+
+    vec4 baseColor = vec4(rCol.r, gCol.g, bCol.b, gCol.a);
+
+    vec4 sum = vec4(0.0);
+    float samples = 8.0;
+    float spread = 0.003;
+
+    for (float i = 0.0; i < samples; i++) {
+        float angle = i * (6.2831 / samples);
+        vec2 offset = vec2(cos(angle), sin(angle)) * spread;
+        vec4 col = texture(texture0, uv + offset);
+
+        float brightness = (col.r + col.g + col.b) / 3.0;
+        if (brightness > 0.6) {
+            sum += col * 0.25;
+        }
+    }
+
+    vec4 glow = sum * 2.0 * effectIntensity;
+    return vec4(baseColor.rgb + glow.rgb, baseColor.a);
+}
+
+void main() {
+    vec2 uv = fragTexCoord;
+
+    // 1. Background, cross-faded between keyframes like BackgroundRenderer::Draw
+    vec3 color = mix(texture(background0, uv).rgb, texture(background1, uv).rgb, backgroundBlend);
+
+    // 2. Scene over it
+    vec4 sceneColor = texture(scene, uv);
+    color = mix(color, sceneColor.rgb, sceneColor.a);
+
+    // 3. UI over everything, alpha blended like the separate post pass
+    vec4 ui = UIPost(uv);
+    color = mix(color, ui.rgb, clamp(ui.a, 0.0, 1.0));
+
+    finalColor = vec4(color, 1.0);
+}
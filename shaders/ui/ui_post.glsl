@@ -9,6 +9,14 @@ uniform float time;
 
 void main() {
     vec2 uv = fragTexCoord;
+
+    // At rest there is no effect at all, the canvas passes through untouched.
+    // UIManager draws it without this shader then, this only keeps the two
+    // paths identical.
+    if (effectIntensity <= 0.0) {
+        finalColor = texture(texture0, uv);
+        return;
+    }
     
     // 1. Chromatic Aberration (The Pulse)
     float amount = 0.005 * effectIntensity;
@@ -37,8 +45,8 @@ void main() {
     }
 
     // 3. Combine base UI with the glow
-    // We multiply sum by 1.5 to make it pop, and baseColor for the sharp text
-    vec4 glow = sum * (1.0 + effectIntensity); 
+    // The glow fades out with the pulse, so dropping the shader at 0 does not pop
+    vec4 glow = sum * 2.0 * effectIntensity;
     finalColor = baseColor + glow;
     
     // Maintain alpha from the original texture
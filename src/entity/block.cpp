@@ -1,5 +0,0 @@
-#include "entity/block.h"
-
-namespace entity {
-
-}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "entity/debris_pool.h"
+#include "raymath.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DEBRIS_USE_SSE 1
+#endif
+
+namespace entity {
+
+// The awake range starts wherever the sleepers end, so arrays get SIMD_WIDTH - 1
+// extra slots for the last batch to run into
+static const size_t SIMD_WIDTH = 4;
+
+DebrisPool::DebrisPool(size_t capacity): capacity(capacity) {
+  size_t padded = capacity + SIMD_WIDTH - 1;
+
+  for (auto *array : { &posX, &posY, &posZ, &lastPosX, &lastPosY, &lastPosZ,
+                       &velX, &velY, &velZ,
+                       &rotX, &rotY, &rotZ, &lastRotX, &lastRotY, &lastRotZ,
+                       &spinX, &spinY, &spinZ, &sizeX, &sizeY, &sizeZ }) {
+    array->assign(padded, 0.0f);
+  }
+  colors.assign(padded, math::Color::White());
+  restSteps.assign(padded, 0);
+}
+
+bool DebrisPool::Spawn(Vector3 position, Vector3 size, Vector3 velocity, Vector3 rotationSpeed, math::Color color) {
+  if (count == capacity) {
+    if (sleeping == 0) {
+      return false;
+    }
+
+    // Sleepers are appended as they settle, so walking them in order gives up
+    // roughly the oldest one. The newest sleeper fills its slot and the last
+    // awake piece fills the newest sleeper's, which frees the end of the pool.
+    if (recycleCursor >= sleeping) recycleCursor = 0;
+    Move(sleeping - 1, recycleCursor++);
+    Move(count - 1, sleeping - 1);
+    sleeping--;
+    count--;
+  }
+
+  size_t i = count++;
+  posX[i] = position.x;       posY[i] = position.y;       posZ[i] = position.z;
+  lastPosX[i] = position.x;   lastPosY[i] = position.y;   lastPosZ[i] = position.z;
+  velX[i] = velocity.x;       velY[i] = velocity.y;       velZ[i] = velocity.z;
+  rotX[i] = 0;                rotY[i] = 0;                rotZ[i] = 0;
+  lastRotX[i] = 0;            lastRotY[i] = 0;            lastRotZ[i] = 0;
+  spinX[i] = rotationSpeed.x; spinY[i] = rotationSpeed.y; spinZ[i] = rotationSpeed.z;
+  sizeX[i] = size.x;          sizeY[i] = size.y;          sizeZ[i] = size.z;
+  colors[i] = color;
+  restSteps[i] = 0;
+  return true;
+}
+
+void DebrisPool::Update(float dt, const LayerHash& colliders, const TowerStore& tower) {
+  // Keep the previous step around so rendering can interpolate, sleepers
+  // already have it equal to the current one
+  size_t first = sleeping;
+  size_t bytes = (count - first) * sizeof(float);
+  memcpy(&lastPosX[first], &posX[first], bytes);
+  memcpy(&lastPosY[first], &posY[first], bytes);
+  memcpy(&lastPosZ[first], &posZ[first], bytes);
+  memcpy(&lastRotX[first], &rotX[first], bytes);
+  memcpy(&lastRotY[first], &rotY[first], bytes);
+  memcpy(&lastRotZ[first], &rotZ[first], bytes);
+
+  Integrate(dt);
+  Collide(colliders, tower);
+  Compact();
+}
+
+Vector3 DebrisPool::Position(size_t i, float alpha) const {
+  return {
+    lastPosX[i] + (posX[i] - lastPosX[i]) * alpha,
+    lastPosY[i] + (posY[i] - lastPosY[i]) * alpha,
+    lastPosZ[i] + (posZ[i] - lastPosZ[i]) * alpha
+  };
+}
+
+Vector3 DebrisPool::Rotation(size_t i, float alpha) const {
+  return {
+    lastRotX[i] + (rotX[i] - lastRotX[i]) * alpha,
+    lastRotY[i] + (rotY[i] - lastRotY[i]) * alpha,
+    lastRotZ[i] + (rotZ[i] - lastRotZ[i]) * alpha
+  };
+}
+
+// Batched version of entity::Physics::Integrate
+void DebrisPool::Integrate(float dt) {
+  size_t i = sleeping;
+
+#ifdef DEBRIS_USE_SSE
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 fall = _mm_set1_ps(gravity * dt);
+
+  for (; i < count; i += SIMD_WIDTH) {
+    __m128 vx = _mm_loadu_ps(&velX[i]);
+    __m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), fall);
+    __m128 vz = _mm_loadu_ps(&velZ[i]);
+    _mm_storeu_ps(&velY[i], vy);
+
+    _mm_storeu_ps(&posX[i], _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(vx, step)));
+    _mm_storeu_ps(&posY[i], _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, step)));
+    _mm_storeu_ps(&posZ[i], _mm_add_ps(_mm_loadu_ps(&posZ[i]), _mm_mul_ps(vz, step)));
+
+    _mm_storeu_ps(&rotX[i], _mm_add_ps(_mm_loadu_ps(&rotX[i]), _mm_mul_ps(_mm_loadu_ps(&spinX[i]), step)));
+    _mm_storeu_ps(&rotY[i], _mm_add_ps(_mm_loadu_ps(&rotY[i]), _mm_mul_ps(_mm_loadu_ps(&spinY[i]), step)));
+    _mm_storeu_ps(&rotZ[i], _mm_add_ps(_mm_loadu_ps(&rotZ[i]), _mm_mul_ps(_mm_loadu_ps(&spinZ[i]), step)));
+  }
+#else
+  // Plain loops over the arrays, simple enough for the compiler to vectorize
+  for (; i < count; i++) {
+    velY[i] += gravity * dt;
+
+    posX[i] += velX[i] * dt;
+    posY[i] += velY[i] * dt;
+    posZ[i] += velZ[i] * dt;
+
+    rotX[i] += spinX[i] * dt;
+    rotY[i] += spinY[i] * dt;
+    rotZ[i] += spinZ[i] * dt;
+  }
+#endif
+}
+
+// Nearest angle that puts a face of the box flat on the ground
+static float SettledAngle(float angle) {
+  const float quarter = PI / 2.0f;
+  return roundf(angle / quarter) * quarter;
+}
+
+void DebrisPool::Collide(const LayerHash& colliders, const TowerStore& tower) {
+  size_t i = sleeping;
+  while (i < count) {
+    float halfX = sizeX[i] / 2, halfY = sizeY[i] / 2, halfZ = sizeZ[i] / 2;
+
+    // 1. Broadphase: a top face under the center that the bounding sphere
+    // reached this step. Rising pieces cannot land.
+    float radius = sqrtf(halfX * halfX + halfY * halfY + halfZ * halfZ);
+    float top = 0.0f;
+    bool contact = velY[i] <= 0.0f && colliders.FindSupport(tower, posX[i], posZ[i], posY[i] - radius, lastPosY[i], top);
+
+    // 2. Narrowphase: how far the rotated box really reaches below its center
+    if (contact) {
+      Matrix rotation = MatrixRotateXYZ(Rotation(i));
+      float extent = fabsf(rotation.m1) * halfX + fabsf(rotation.m5) * halfY + fabsf(rotation.m9) * halfZ;
+      // Rolling onto a face lowers the extent, the slop keeps it in contact meanwhile
+      contact = posY[i] - extent <= top + DEBRIS_CONTACT_SLOP;
+
+      if (contact) {
+        posY[i] = top + extent;
+        velY[i] = (-velY[i] > DEBRIS_MIN_BOUNCE) ? -velY[i] * DEBRIS_RESTITUTION : 0.0f;
+        velX[i] *= DEBRIS_FRICTION;
+        velZ[i] *= DEBRIS_FRICTION;
+        spinX[i] *= DEBRIS_SPIN_DAMPING;
+        spinY[i] *= DEBRIS_SPIN_DAMPING;
+        spinZ[i] *= DEBRIS_SPIN_DAMPING;
+
+        // Tumble over onto the nearest face instead of stopping on an edge
+        rotX[i] += (SettledAngle(rotX[i]) - rotX[i]) * DEBRIS_SETTLE_RATE;
+        rotY[i] += (SettledAngle(rotY[i]) - rotY[i]) * DEBRIS_SETTLE_RATE;
+        rotZ[i] += (SettledAngle(rotZ[i]) - rotZ[i]) * DEBRIS_SETTLE_RATE;
+      }
+    }
+
+    // 3. Long enough at rest and it leaves the awake range
+    float speed = velX[i] * velX[i] + velY[i] * velY[i] + velZ[i] * velZ[i];
+    float spin = spinX[i] * spinX[i] + spinY[i] * spinY[i] + spinZ[i] * spinZ[i];
+    const float limit = DEBRIS_SLEEP_SPEED * DEBRIS_SLEEP_SPEED;
+    bool resting = contact && speed < limit && spin < limit;
+
+    restSteps[i] = resting ? restSteps[i] + 1 : 0;
+    if (restSteps[i] >= DEBRIS_SLEEP_STEPS) {
+      Sleep(i); // An already checked piece moves into i
+    }
+    i++;
+  }
+}
+
+void DebrisPool::Compact() {
+  size_t i = sleeping;
+  while (i < count) {
+    if (posY[i] < DEBRIS_KILL_HEIGHT) {
+      Remove(i); // The last piece moves into i, check it again
+    } else {
+      i++;
+    }
+  }
+}
+
+void DebrisPool::Sleep(size_t i) {
+  // Nothing moves while asleep, the snapshot should not blend it either
+  velX[i] = velY[i] = velZ[i] = 0.0f;
+  spinX[i] = spinY[i] = spinZ[i] = 0.0f;
+  lastPosX[i] = posX[i]; lastPosY[i] = posY[i]; lastPosZ[i] = posZ[i];
+  lastRotX[i] = rotX[i]; lastRotY[i] = rotY[i]; lastRotZ[i] = rotZ[i];
+
+  Swap(i, sleeping++);
+}
+
+DebrisPool::Piece DebrisPool::Get(size_t i) const {
+  Piece piece = {}; // Padding included, the bytes end up in save files
+  piece.position = { posX[i], posY[i], posZ[i] };
+  piece.lastPosition = { lastPosX[i], lastPosY[i], lastPosZ[i] };
+  piece.velocity = { velX[i], velY[i], velZ[i] };
+  piece.rotation = { rotX[i], rotY[i], rotZ[i] };
+  piece.lastRotation = { lastRotX[i], lastRotY[i], lastRotZ[i] };
+  piece.spin = { spinX[i], spinY[i], spinZ[i] };
+  piece.size = { sizeX[i], sizeY[i], sizeZ[i] };
+  piece.color = colors[i];
+  piece.restSteps = restSteps[i];
+  return piece;
+}
+
+void DebrisPool::Assign(const Piece *pieces, size_t count, size_t sleeping) {
+  this->count = count < capacity ? count : capacity;
+  this->sleeping = sleeping < this->count ? sleeping : this->count;
+  recycleCursor = 0;
+
+  for (size_t i = 0; i < this->count; i++) {
+    const Piece& piece = pieces[i];
+    posX[i] = piece.position.x;         posY[i] = piece.position.y;         posZ[i] = piece.position.z;
+    lastPosX[i] = piece.lastPosition.x; lastPosY[i] = piece.lastPosition.y; lastPosZ[i] = piece.lastPosition.z;
+    velX[i] = piece.velocity.x;         velY[i] = piece.velocity.y;         velZ[i] = piece.velocity.z;
+    rotX[i] = piece.rotation.x;         rotY[i] = piece.rotation.y;         rotZ[i] = piece.rotation.z;
+    lastRotX[i] = piece.lastRotation.x; lastRotY[i] = piece.lastRotation.y; lastRotZ[i] = piece.lastRotation.z;
+    spinX[i] = piece.spin.x;            spinY[i] = piece.spin.y;            spinZ[i] = piece.spin.z;
+    sizeX[i] = piece.size.x;            sizeY[i] = piece.size.y;            sizeZ[i] = piece.size.z;
+    colors[i] = piece.color;
+    restSteps[i] = piece.restSteps;
+  }
+}
+
+void DebrisPool::Remove(size_t i) {
+  Move(--count, i);
+}
+
+void DebrisPool::Move(size_t from, size_t to) {
+  if (from == to) return;
+
+  posX[to] = posX[from];   posY[to] = posY[from];   posZ[to] = posZ[from];
+  lastPosX[to] = lastPosX[from]; lastPosY[to] = lastPosY[from]; lastPosZ[to] = lastPosZ[from];
+  velX[to] = velX[from];   velY[to] = velY[from];   velZ[to] = velZ[from];
+  rotX[to] = rotX[from];   rotY[to] = rotY[from];   rotZ[to] = rotZ[from];
+  lastRotX[to] = lastRotX[from]; lastRotY[to] = lastRotY[from]; lastRotZ[to] = lastRotZ[from];
+  spinX[to] = spinX[from]; spinY[to] = spinY[from]; spinZ[to] = spinZ[from];
+  sizeX[to] = sizeX[from]; sizeY[to] = sizeY[from]; sizeZ[to] = sizeZ[from];
+  colors[to] = colors[from];
+  restSteps[to] = restSteps[from];
+}
+
+void DebrisPool::Swap(size_t a, size_t b) {
+  if (a == b) return;
+
+  for (auto *array : { &posX, &posY, &posZ, &lastPosX, &lastPosY, &lastPosZ,
+                       &velX, &velY, &velZ,
+                       &rotX, &rotY, &rotZ, &lastRotX, &lastRotY, &lastRotZ,
+                       &spinX, &spinY, &spinZ, &sizeX, &sizeY, &sizeZ }) {
+    std::swap((*array)[a], (*array)[b]);
+  }
+  std::swap(colors[a], colors[b]);
+  std::swap(restSteps[a], restSteps[b]);
+}
+
+}
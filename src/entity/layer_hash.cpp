@@ -0,0 +1,71 @@
+#include "entity/layer_hash.h"
+#include <cmath>
+
+namespace entity {
+
+void LayerHash::Clear() {
+  // Keep the buckets, the next run fills the same layers again
+  for (auto& cell : cells) cell.second.clear();
+  count = 0;
+}
+
+void LayerHash::Insert(Vector3 center, Vector3 size) {
+  BoundingBox box = {
+    { center.x - size.x / 2, center.y - size.y / 2, center.z - size.z / 2 },
+    { center.x + size.x / 2, center.y + size.y / 2, center.z + size.z / 2 }
+  };
+  cells[Key(box.max.y)].push_back(box);
+  highest = (count == 0) ? box.max.y : fmaxf(highest, box.max.y);
+  count++;
+}
+
+bool LayerHash::FindSupport(const TowerStore& tower, float x, float z, float low, float high, float& top) const {
+  // Most falling pieces are nowhere near anything, skip the lookups for them
+  float ceiling = highest;
+  if (!tower.Empty()) {
+    const Block& towerTop = tower.Top();
+    float towerHighest = towerTop.position.y + towerTop.size.y / 2;
+    ceiling = (count == 0) ? towerHighest : fmaxf(ceiling, towerHighest);
+  } else if (count == 0) {
+    return false;
+  }
+  if (low > ceiling) return false;
+  high = fminf(high, ceiling);
+
+  // Walk down from the highest layer, a hit there beats anything below it
+  for (int32_t key = Key(high); key >= Key(low); key--) {
+    bool found = false;
+    auto check = [&](const BoundingBox& box) {
+      if (box.max.y < low || box.max.y > high) return;
+      if (x < box.min.x || x > box.max.x || z < box.min.z || z > box.max.z) return;
+      if (!found || box.max.y > top) top = box.max.y;
+      found = true;
+    };
+
+    // 1. Boxes of this layer
+    auto cell = cells.find(key);
+    if (cell != cells.end()) {
+      for (const BoundingBox& box : cell->second) check(box);
+    }
+
+    // 2. The tower block of this layer, its neighbours too in case rounding
+    // put a top face just across the boundary
+    for (int64_t i = (int64_t)key - 1; i <= (int64_t)key + 1; i++) {
+      if (i < 0 || (size_t)i >= tower.Size()) continue;
+
+      Block block = tower.Get((size_t)i);
+      Vector3 half = { block.size.x / 2, block.size.y / 2, block.size.z / 2 };
+      if (Key(block.position.y + half.y) != key) continue;
+      check({ { block.position.x - half.x, block.position.y - half.y, block.position.z - half.z },
+              { block.position.x + half.x, block.position.y + half.y, block.position.z + half.z } });
+    }
+    if (found) return true;
+  }
+  return false;
+}
+
+int32_t LayerHash::Key(float y) const {
+  return (int32_t)floorf(y / layerHeight);
+}
+
+}
@@ -0,0 +1,52 @@
+#include "entity/tower_store.h"
+#include <cmath>
+
+namespace entity {
+
+static int32_t Quantize(float value, float scale, int32_t min, int32_t max) {
+  int32_t q = (int32_t)lroundf(value * scale);
+  return q < min ? min : (q > max ? max : q);
+}
+
+PackedBlock Pack(const Block& block) {
+  PackedBlock packed;
+  packed.y = block.position.y;
+  packed.x = (int16_t)Quantize(block.position.x, TOWER_POSITION_SCALE, INT16_MIN, INT16_MAX);
+  packed.z = (int16_t)Quantize(block.position.z, TOWER_POSITION_SCALE, INT16_MIN, INT16_MAX);
+  packed.sizeX = (uint16_t)Quantize(block.size.x, TOWER_SIZE_SCALE, 0, UINT16_MAX);
+  packed.sizeZ = (uint16_t)Quantize(block.size.z, TOWER_SIZE_SCALE, 0, UINT16_MAX);
+  packed.sizeY = (uint8_t)Quantize(block.size.y, TOWER_HEIGHT_SCALE, 0, UINT8_MAX);
+  packed.r = block.color.r;
+  packed.g = block.color.g;
+  packed.b = block.color.b;
+  return packed;
+}
+
+Block Unpack(const PackedBlock& packed, size_t index) {
+  Vector3 position = { packed.x / TOWER_POSITION_SCALE, packed.y, packed.z / TOWER_POSITION_SCALE };
+  Vector3 size = { packed.sizeX / TOWER_SIZE_SCALE, packed.sizeY / TOWER_HEIGHT_SCALE, packed.sizeZ / TOWER_SIZE_SCALE };
+  return Block(index, position, size, { packed.r, packed.g, packed.b, 255 });
+}
+
+void TowerStore::Clear() {
+  settled.clear();
+  top = Block();
+  hasTop = false;
+}
+
+void TowerStore::Push(const Block& block) {
+  if (hasTop) settled.push_back(Pack(top));
+
+  top = block;
+  top.index = settled.size();
+  hasTop = true;
+}
+
+void TowerStore::Assign(const PackedBlock *records, size_t count, const Block& block) {
+  settled.assign(records, records + count);
+  top = block;
+  top.index = count;
+  hasTop = true;
+}
+
+}
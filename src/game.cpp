@@ -1,8 +1,10 @@
 #include "game.h"
 #include "external/reasings.h"
-#include "entity/movement.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+#include "util/profiler.h"
+#include <cstdint>
 
 Game::Game()
 {
@@ -15,89 +17,181 @@ Game::Game()
   };
 
   this->mainCamera = camera;
+  this->renderCamera = camera;
 }
 
-void Game::Update(float dt)
+void Game::Start()
 {
-  UpdateGameState();
-  UpdateCameraPosition(dt);
-  UpdateFallingBlocks(dt);
-  UpdateCurrentBlock(dt);
-  uiManager.Update(dt); // UI Manager handles its own timers now!
+  InitGame();
+  simThread.Start(REPLAY_FILE);
 }
 
-void DrawTerrain()
+void Game::Stop()
 {
-  DrawCube({0, -2, 0}, 50, 4, 50, {0xac, 0xca, 0x84, 255}); // TODO: Change for terrain.Draw() and terrain.update() in the future
+  simThread.Stop();
 }
 
-void Game::Render3D()
+bool Game::SaveState(const char *path)
 {
-  SetShaderValue(this->lighting_shader, GetShaderLocation(this->lighting_shader, "cameraPosition"), &this->mainCamera.position, SHADER_UNIFORM_VEC3);
-  BeginMode3D(this->mainCamera);
-    DrawTerrain();
-    DrawPlacedBlocks();
-    DrawFallingBlocks();
-    DrawCurrentBlock();
-  EndMode3D();
+  saveWriter.Begin();
+  simThread.Save(saveWriter);
+  uiManager.Save(saveWriter);
+  return saveWriter.WriteFile(path);
 }
 
-void Game::Render(float dt)
+bool Game::LoadState(const char *path, const char **error)
 {
-  Render3D();
+  sim::SaveReader reader;
+  bool ok = reader.Open(path) && simThread.Load(reader);
+  if (!ok) {
+    if (error) *error = reader.Error() ? reader.Error() : "no run in the file";
+    return false;
+  }
 
-  // 2. Draw HUD to the Canvas
-  uiManager.BeginUI();
-    uiManager.DrawScore(this->placed_blocks.size() - 1);
+  // Without a UI section the run still resumes, just with no messages up
+  uiManager.Load(reader);
+  return true;
+}
+
+void Game::HandleInput()
+{
+  // The simulation thread queues it until the step it falls into
+  if (IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    simThread.PushPress(sim::Clock());
+  }
+}
+
+void Game::Update(float frameTime)
+{
+  simThread.AcquireSnapshot();
+  const sim::FrameSnapshot& snapshot = simThread.Snapshot();
+
+  SyncTower(snapshot);
+  UpdateGameState(snapshot);
+
+  PROFILE_SCOPE(util::PHASE_UI_UPDATE);
+  uiManager.Update(frameTime); // UI Manager handles its own timers now!
+}
+
+void Game::SyncTower(const sim::FrameSnapshot& snapshot)
+{
+  // 1. A new run started, its tower shares nothing with the old one
+  if (snapshot.generation != this->generation) {
+    this->generation = snapshot.generation;
+    InitGame();
+  }
+
+  // 2. Placed blocks never change, only the ones not mirrored yet get copied
+  size_t first = snapshot.placedCount - snapshot.recentCount;
+  if (this->tower.Size() < first && snapshot.towerCopy) {
+    // A prebuilt or loaded tower arrives in one go, far more than fits in recent
+    const entity::TowerStore& copy = *snapshot.towerCopy;
+    size_t end = copy.Size() < first ? copy.Size() : first;
+    this->tower.Reserve(end);
+    for (size_t i = this->tower.Size(); i < end; i++) this->tower.Push(copy.Get(i));
+  }
+  if (this->tower.Size() < first) {
+    // A long stall (minimised window, debugger, slow frame) let recent run
+    // past the mirror. Keep it as it is until a copy of the tower arrives
+    // rather than guess the blocks in between.
+    simThread.RequestTowerCopy();
+    return;
+  }
+  for (size_t i = this->tower.Size(); i < snapshot.placedCount; i++) {
+    this->tower.Push(snapshot.recent[i - first]);
+  }
+}
+
+void DrawTerrain()
+{
+  DrawCube(sim::TERRAIN_POSITION, sim::TERRAIN_SIZE.x, sim::TERRAIN_SIZE.y, sim::TERRAIN_SIZE.z, {0xac, 0xca, 0x84, 255}); // TODO: Change for terrain.Draw() and terrain.update() in the future
+}
+
+void Game::Render3D(const sim::FrameSnapshot& snapshot, float alpha, render::CommandBuffer& commands)
+{
+  PROFILE_SCOPE(util::PHASE_RENDER_3D);
+
+  UpdateCamera(snapshot, alpha);
+
+  this->lighting_material.cameraPosition.Set(this->renderCamera.position);
+  this->tower_lighting_material.cameraPosition.Set(this->renderCamera.position);
+
+  // Settled blocks are baked into static chunks, only the newest ones stay instanced
+  towerChunks.Sync(this->tower);
+
+  commands.SetCamera(this->renderCamera);
+  commands.Custom(render::RenderPass::OPAQUE_3D, [] { DrawTerrain(); }, rlGetShaderIdDefault());
+  towerChunks.Draw(this->renderCamera, (float)GetScreenWidth() / GetScreenHeight(), this->tower_material, commands);
+
+  // Every block in the scene goes out in a single instanced draw
+  blockRenderer.Begin();
+  DrawPlacedBlocks();
+  DrawFallingBlocks(snapshot, alpha);
+  DrawCurrentBlock(snapshot, alpha);
+  blockRenderer.Flush(this->cube_mesh.Get(), this->cube_material, commands);
+}
+
+void Game::DrawHUD()
+{
+  // Most frames the canvas already shows all of this
+  if (!uiManager.BeginUI()) return;
+  {
+    PROFILE_SCOPE(util::PHASE_UI_DRAW);
+    uiManager.DrawScore();
     
     uiManager.DrawActiveOverlay();
+    uiManager.DrawMessages();
+  }
   uiManager.EndUI();
+}
+
+void Game::Render(render::CommandBuffer& commands)
+{
+  const sim::FrameSnapshot& snapshot = simThread.Snapshot();
+
+  // The snapshot is one step ahead of the clock time it was published for,
+  // rendering blends towards it from the step before
+  float alpha = (float)((sim::Clock() - snapshot.stepTime) / sim::SIMULATION_STEP);
+  alpha = Clamp(alpha, 0.0f, 1.0f);
+
+  // 1. Scene, sorted by shader and mesh when submitted
+  Render3D(snapshot, alpha, commands);
+
+  // 2. Draw HUD to the Canvas
+  commands.Custom(render::RenderPass::UI, [this] { DrawHUD(); });
 
   // 3. Draw Canvas to screen with the Post-Processing Shader
-  uiManager.Render();
+  uiManager.Render(commands);
 }
 
-void Game::UpdateGameState() {
-    bool inputPressed = IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+void Game::UpdateGameState(const sim::FrameSnapshot& snapshot) {
+    // Snapshots can be skipped, the running total catches every PERFECT
+    if (snapshot.perfectCount > this->perfectCount) uiManager.SpawnPerfect();
+    this->perfectCount = snapshot.perfectCount;
+    uiManager.SetScore(snapshot.score);
 
-    switch (this->state) {
-        case READY_STATE:
+    switch (snapshot.state) {
+        case sim::READY_STATE:
             uiManager.SetState(ui::UIState::START); // Sync UI State
-            if (inputPressed) {
-                this->state = PLAYING_STATE;
-                uiManager.SetState(ui::UIState::PLAYING);
-                this->current_block = CreateMovingBlock();
-            }
             break;
 
-        case PLAYING_STATE:
-            if (inputPressed) {
-                PlaceBlock();
-                this->current_block = CreateMovingBlock();
-            }
+        case sim::PLAYING_STATE:
+            uiManager.SetState(ui::UIState::PLAYING);
             break;
 
-        case GAME_OVER_STATE:
+        case sim::GAME_OVER_STATE:
             uiManager.SetState(ui::UIState::GAME_OVER); // Sync UI State
-            if (inputPressed) InitGame();
             break;
     }
 }
 
-void Game::UpdateCameraPosition(float dt) {
-  size_t placed_blocks_len = this->placed_blocks.size();
-
-  this->mainCamera.position.y = Lerp(this->mainCamera.position.y, 50 + (2 * placed_blocks_len), dt);
-  this->mainCamera.target.y = Lerp(this->mainCamera.target.y, 2 * placed_blocks_len, dt);
-}
-
-void Game::UpdateCurrentBlock(float dt) {
-    if (this->state != PLAYING_STATE) return;
+void Game::UpdateCamera(const sim::FrameSnapshot& snapshot, float alpha) {
+  this->mainCamera.position.y = snapshot.cameraY;
+  this->mainCamera.target.y = snapshot.cameraTargetY;
 
-    // Delegate the movement logic to the component we built!
-    if (current_block.movement) {
-        current_block.movement->Update(current_block.position, dt);
-    }
+  this->renderCamera = this->mainCamera;
+  this->renderCamera.position.y = Lerp(snapshot.previousCameraY, snapshot.cameraY, alpha);
+  this->renderCamera.target.y = Lerp(snapshot.previousCameraTargetY, snapshot.cameraTargetY, alpha);
 }
 
 void Game::UpdateScore(float dt) {
@@ -141,70 +235,49 @@ void Game::UpdateOverlay(float dt) {
   }
 }
 
-void Game::UpdateFallingBlocks(float dt) {
-  for (auto& block : falling_blocks)
-  {
-    if (block.physics)
-    {
-      block.physics->Integrate(block.position, dt);
-
-      if (block.position.y < -50.f)
-      {
-        block.physics = nullptr;
-      }
-    }
-  }
-}
-
-entity::Block& Game::GetPreviousBlock() {
-    return placed_blocks[previousBlockIndex];
-}
-
-void Game::DrawBlock(const entity::Block *block, Shader lightingShader) {
-  math::Color color = block->color;
-  Vector4 normalizedColor = ColorNormalize({.r = color.r, .g = color.g, .b = color.b, .a = color.a});
-  Vector3 normalizedColorVec3 = {.x=normalizedColor.x, .y=normalizedColor.y, .z=normalizedColor.z};
-  SetShaderValue(lightingShader, GetShaderLocation(lightingShader, "blockColor"), &normalizedColorVec3, SHADER_UNIFORM_VEC3);
-  BeginShaderMode(lightingShader);
-    DrawCube(block->position, block->size.x, block->size.y, block->size.z, {.r = color.r, .g = color.g, .b = color.b, .a = color.a});
-  EndShaderMode();
-}
-
-void Game::DrawCurrentBlock() {
-  if (this->state != PLAYING_STATE) {
+void Game::DrawCurrentBlock(const sim::FrameSnapshot& snapshot, float alpha) {
+  if (snapshot.state != sim::PLAYING_STATE) {
     return;
   }
 
-  DrawBlock(&this->current_block, this->lighting_shader);
+  const entity::Block& block = snapshot.current;
+  Vector3 position = Vector3Lerp(snapshot.currentLastPosition, block.position, alpha);
+  blockRenderer.Submit(position, block.size, block.color);
 }
 
 void Game::DrawPlacedBlocks() {
-  const std::vector<entity::Block>& blocks = this->placed_blocks;
-
-  for (size_t i = 0; i < blocks.size(); i++) {
-    const entity::Block *block = &blocks[i];
-    DrawBlock(block, this->lighting_shader);
+  for (size_t i = towerChunks.BakedCount(); i < this->tower.Size(); i++) {
+    entity::Block block = this->tower.Get(i);
+    blockRenderer.Submit(block.position, block.size, block.color);
   }
 }
-void Game::InitGame() {
-  this->lighting_shader = LoadShader("shaders/3d/lighting_vertex.glsl", "shaders/3d/lighting_fragment.glsl");
-  this->cube_model = LoadModelFromMesh(GenMeshCube(1, 1, 1));
-  
-  this->state = READY_STATE;
-  this->placed_blocks.clear();
-  this->falling_blocks.clear();
+void Game::LoadResources() {
+  this->lighting_material.Load(render::LightingVariant::INSTANCED);
+  this->cube_mesh = render::ResourceCache::Instance().AcquireMesh("cube", [] { return GenMeshCube(1, 1, 1); });
+  this->cube_material = LoadMaterialDefault();
+  this->cube_material.shader = this->lighting_material.shader;
+
+  this->tower_lighting_material.Load(render::LightingVariant::STATIC_MESH);
+  this->tower_lighting_material.blockColor.Set({ 1.0f, 1.0f, 1.0f });
+  this->tower_material = LoadMaterialDefault();
+  this->tower_material.shader = this->tower_lighting_material.shader;
+}
 
-  // 1. Create and move the BASE block into the tower first
-  entity::Block baseBlock(0, {0,0,0}, {10, 2, 10}, {255, 255, 255, 255});
-  this->placed_blocks.push_back(std::move(baseBlock));
+void Game::UnloadResources() {
+  // UnloadMaterial would also unload the shader, which the cache owns, so
+  // only free the maps here
+  MemFree(this->cube_material.maps);
+  this->cube_mesh.Reset();
+  this->lighting_material.Unload();
 
-  // 2. NOW it is safe to point to it
-  this->previous_block = &this->placed_blocks.back();
+  this->towerChunks.Clear();
+  MemFree(this->tower_material.maps);
+  this->tower_lighting_material.Unload();
+}
 
-  // 3. Create the first MOVING block (the one the player controls)
-  // Note: Ensure your Block constructor handles these arguments
-  this->current_block = entity::Block(1, {0, 2, 0}, {10, 2, 10}, {200, 200, 200, 255});
-  this->current_block.color_offset = GetRandomValue(0, 100);
+void Game::InitGame() {
+  this->tower.Clear();
+  this->towerChunks.Clear();
 
   // ... Animation Init ...
   this->scoreAnimation.duration = SCORE_ANIMATION_DURATION;
@@ -217,157 +290,11 @@ void Game::InitGame() {
     .offsetY = OVERLAY_ANIMATION_OFFSET_Y
   };
 }
-entity::Block Game::CreateMovingBlock() {
-    entity::Block* target = this->previous_block;
-
-    // 1. Determine Axis (Flip from X to Z or vice versa)
-    // Note the -> arrow for the unique_ptr
-    entity::Axis axis = (target->index % 2 == 0) ? entity::Z : entity::X;
-    entity::Direction direction = (GetRandomValue(0, 1) == 0) ? entity::FORWARD : entity::BACKWARD;
-
-    // 2. Calculate Position
-    Vector3 position = target->position;
-    position.y += target->size.y;
-
-    if (axis == entity::X) {
-        position.x = (direction == entity::FORWARD ? -1 : 1) * MOVEMENT_THRESHOLD;
-    } else {
-        position.z = (direction == entity::FORWARD ? -1 : 1) * MOVEMENT_THRESHOLD;
-    }
-
-    // 3. Generate Color
-    size_t index = target->index + 1;
-    int offset = target->color_offset + (int)index;
-    math::Color newColor = {
-        (unsigned char)(sinf(0.3f * offset) * 55 + 200),
-        (unsigned char)(sinf(0.3f * offset + 2.0f) * 55 + 200),
-        (unsigned char)(sinf(0.3f * offset + 4.0f) * 55 + 200),
-        255
-    };
-
-    // 4. Construct the Block
-    entity::Block newBlock(index, position, target->size, newColor);
-    newBlock.color_offset = target->color_offset;
-
-    // 5. Configure Movement using our new method
-    float speed = 16.0f + (index * 0.5f);
-    newBlock.SetMoving({.speed = speed, .direction = direction, .axis = axis});
-
-    // 6. Move it out (Crucial for unique_ptr support)
-    return newBlock;
-}
-
-entity::Block Game::CreateFallingBlock(Vector3 position, Vector3 size, math::Color color) {
-    // 1. Create a standard block (id 0 because debris doesn't need an index)
-    entity::Block debris(0, position, size, color);
-
-    // 2. Randomize the "tumble" velocity
-    Vector3 initialVel = {
-        (float)GetRandomValue(-300, 300) / 100.0f,
-        (float)GetRandomValue(-100, 100) / 100.0f, // Slight vertical pop
-        (float)GetRandomValue(-300, 300) / 100.0f
-    };
-
-    // 3. Use the state-transition method we built
-    // This internally creates the Physics component and sets the state
-    debris.SetFalling(initialVel);
-
-    // 4. Return it using move semantics
-    return debris;
-}
-void Game::PlaceBlock() {
-  entity::Block& current = this->current_block; 
-  entity::Block& target = *this->previous_block;
-
-  bool isXAxis = current.movement->axis == entity::X;
-  float currentPos = isXAxis ? current.position.x : current.position.z;
-  float targetPos  = isXAxis ? target.position.x  : target.position.z;
-  float currentSize = isXAxis ? current.size.x    : current.size.z;
-  float targetSize  = isXAxis ? target.size.x     : target.size.z;
-
-  float delta = currentPos - targetPos;
-  float overlay = targetSize - fabs(delta);
-
-  // Game Over Check
-  if (overlay < 0.1f) {
-    this->state = GAME_OVER_STATE;
-    return;
-  }
-
-  bool isPerfect = fabs(delta) < 0.3f;
-
-  if (isPerfect) {
-    // Snap to target for that "Perfect" feel
-    if (isXAxis) current.position.x = target.position.x;
-    else         current.position.z = target.position.z;
-    
-    uiManager.SpawnPerfect();
-  } else {
-    // --- THE SLICE (The part that stays) ---
-    float newSize = overlay;
-    float newPos = targetPos + (delta / 2.0f);
-
-    // --- THE CHOP (The debris) ---
-    float choppedSize = currentSize - overlay;
-    float choppedPos = (delta > 0) 
-        ? (newPos + newSize / 2.0f + choppedSize / 2.0f) 
-        : (newPos - newSize / 2.0f - choppedSize / 2.0f);
-
-    // Update Current Block Size/Pos
-    if (isXAxis) {
-      current.size.x = newSize;
-      current.position.x = newPos;
-    } else {
-      current.size.z = newSize;
-      current.position.z = newPos;
-    }
-
-    // Create the debris block
-    Vector3 dPos = current.position;
-    Vector3 dSize = current.size;
-    if (isXAxis) { dPos.x = choppedPos; dSize.x = choppedSize; }
-    else         { dPos.z = choppedPos; dSize.z = choppedSize; }
-
-    this->falling_blocks.push_back(CreateFallingBlock(dPos, dSize, current.color));
-  }
-
-  // 2. Finalize the Current Block state
-  current.SetPlaced();
-
-  // 3. Move it to the tower (Current becomes empty here!)
-  this->placed_blocks.push_back(std::move(current));
-  
-  // 4. Update the 'previous' pointer safely
-  this->previous_block = &this->placed_blocks.back();
-
-  // 5. Spawn the next moving block
-  this->current_block = CreateMovingBlock();
-}
-
-void Game::DrawFallingBlocks() {
-    for (auto& block : this->falling_blocks) {
-        // We only draw blocks that actually have physics (debris)
-        if (block.physics) {
-            // 1. Build the Transformation Matrix
-            // Rotation is now retrieved from the physics component
-            auto scale     = MatrixScale(block.size.x, block.size.y, block.size.z);
-            auto rotate    = MatrixRotateXYZ(block.physics->rotation); 
-            auto translate = MatrixTranslate(block.position.x, block.position.y, block.position.z);
-            
-            // Combine: Scale -> Rotate -> Translate (SRT Order)
-            this->cube_model.transform = MatrixMultiply(scale, MatrixMultiply(rotate, translate));
-
-            // 2. Update Shader Uniforms
-            ::Color rayColor = { block.color.r, block.color.g, block.color.b, block.color.a };
-            Vector4 normalized = ColorNormalize(rayColor);
-            Vector3 colorVec3 = { normalized.x, normalized.y, normalized.z };
-            
-            int loc = GetShaderLocation(this->lighting_shader, "blockColor");
-            SetShaderValue(this->lighting_shader, loc, &colorVec3, SHADER_UNIFORM_VEC3);
-            
-            // 3. Render the Model
-            this->cube_model.materials[0].shader = this->lighting_shader;
-            DrawModel(this->cube_model, {0, 0, 0}, 1.0f, rayColor);
-        }
+void Game::DrawFallingBlocks(const sim::FrameSnapshot& snapshot, float alpha) {
+    // Only live debris is in the snapshot
+    for (const sim::DebrisInstance& piece : snapshot.debris) {
+        Vector3 position = Vector3Lerp(piece.lastPosition, piece.position, alpha);
+        Vector3 rotation = Vector3Lerp(piece.lastRotation, piece.rotation, alpha);
+        blockRenderer.Submit(position, piece.size, rotation, piece.color);
     }
 }
\ No newline at end of file
@@ -1,54 +1,285 @@
 #include "raylib.h"
 #include "game.h"
+#include "render/background_renderer.h"
+#include "render/command_buffer.h"
+#include "render/resolution_governor.h"
+#include "render/resource_cache.h"
+#include "sim/replay.h"
+#include "sim/stress.h"
+#include "ui/profiler_overlay.h"
+#include "util/frame_arena.h"
+#include "util/memory_usage.h"
+#include "util/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
 
 const int WINDOW_WIDTH = 600;
 const int WINDOW_HEIGHT = 1000;
+const char *PROFILE_FILE = "profile.csv";
+const double INPUT_POLL_INTERVAL = 0.001; // Seconds between polls while pacing
+
+enum FramePacing {
+  PACING_SLEEP,   // Sleep in short slices, polling input after each one
+  PACING_RAYLIB   // SetTargetFPS, raylib waits (partly busy) inside EndDrawing
+};
 const Color BG_COLOR = (Color){.r = 0x87, .g = 0xCE, .b = 0xEB, .a = 255};
 
-int main() {
+/// @brief Headless: re-simulates every run in a replay file and checks it
+static int VerifyReplays(const char *path) {
+  sim::ReplayReader reader;
+  if (!reader.Open(path)) {
+    fprintf(stderr, "Could not read replay file %s\n", path);
+    return 1;
+  }
+
+  sim::Simulation simulation;
+  sim::ReplayPlayer player(simulation);
+  sim::ReplayRun run;
+  int runs = 0, failures = 0;
+
+  while (reader.Next(run)) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = player.Verify(run);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("run %d: score %llu, %llu ticks, %.3f ms, %s\n", runs, (unsigned long long)run.score,
+           (unsigned long long)run.finalTick, ms, ok ? "ok" : "MISMATCH");
+    runs++;
+    if (!ok) failures++;
+  }
+
+  printf("%d runs, %d mismatches", runs, failures);
+  if (reader.Skipped() > 0) printf(", %zu runs of older versions skipped", reader.Skipped());
+  printf("\n");
+  // Stopping before the end of the file must not pass as a clean run
+  if (reader.Error()) {
+    fprintf(stderr, "Stopped reading %s after %d runs: %s\n", path, runs, reader.Error());
+    return 1;
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+/// @brief Prints the p50/p95/p99/max of samples (milliseconds)
+static void PrintPercentiles(const char *label, std::vector<float> samples) {
+  if (samples.empty()) return;
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](float p) { return samples[(size_t)(p * (samples.size() - 1) + 0.5f)]; };
+  printf("%-6s p50 %7.3f  p95 %7.3f  p99 %7.3f  max %7.3f ms\n", label,
+         percentile(0.50f), percentile(0.95f), percentile(0.99f), samples.back());
+}
+
+/// @brief Summary of a --stress run, frame is the full interval (pacing
+/// included), work the part of it spent before sleeping
+static void PrintStressReport(const sim::StressSettings& stress, const std::vector<float>& frameMs,
+                              const std::vector<float>& workMs) {
+  printf("stress: tower %zu, %.0f debris/s (capacity %zu), %.0f perfects/s, %.1f s, %zu frames\n",
+         stress.towerHeight, stress.debrisPerSecond, stress.debrisCapacity, stress.perfectsPerSecond,
+         stress.seconds, frameMs.size());
+  PrintPercentiles("frame", frameMs);
+  PrintPercentiles("work", workMs);
+
+  size_t peak = util::PeakResidentBytes();
+  if (peak > 0) printf("peak memory %.1f MB\n", peak / (1024.0 * 1024.0));
+  else          printf("peak memory n/a\n");
+}
+
+/// @brief Sleeps until deadline, polling input every INPUT_POLL_INTERVAL so
+/// presses get stamped within a millisecond of arriving instead of once a frame
+static void SleepUntil(double deadline, const std::function<void()>& onPoll) {
+  for (double remaining = deadline - GetTime(); remaining > 0; remaining = deadline - GetTime()) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(fmin(remaining, INPUT_POLL_INTERVAL)));
+    PollInputEvents();
+    onPoll();
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+    return VerifyReplays(argv[2]);
+  }
+
+  // --stress alone uses the StressSettings defaults, any --stress-* flag implies it
+  FramePacing pacing = PACING_SLEEP;
+  bool mergedComposite = false;
+  const char *loadPath = nullptr; // A save to resume, e.g. a dump from another session
+  sim::StressSettings stress;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : "";
+    if (strncmp(arg, "--stress", 8) == 0) stress.enabled = true;
+
+    if (strcmp(arg, "--pacing") == 0 && strcmp(value, "raylib") == 0) pacing = PACING_RAYLIB;
+    else if (strcmp(arg, "--merged-composite") == 0) mergedComposite = true;
+    else if (strcmp(arg, "--load") == 0 && *value) loadPath = value;
+    else if (strcmp(arg, "--stress-tower") == 0) stress.towerHeight = strtoull(value, nullptr, 10);
+    else if (strcmp(arg, "--stress-debris") == 0) stress.debrisPerSecond = (float)atof(value);
+    else if (strcmp(arg, "--stress-capacity") == 0) stress.debrisCapacity = strtoull(value, nullptr, 10);
+    else if (strcmp(arg, "--stress-perfects") == 0) stress.perfectsPerSecond = (float)atof(value);
+    else if (strcmp(arg, "--stress-seconds") == 0) stress.seconds = (float)atof(value);
+  }
+
   InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Tower Blocks");
 
   int monitorHz = GetMonitorRefreshRate(GetCurrentMonitor());
-  SetTargetFPS(monitorHz);
+  if (monitorHz <= 0) monitorHz = 60;
+  if (pacing == PACING_RAYLIB) SetTargetFPS(monitorHz);
+  double frameBudget = 1.0 / monitorHz;
+
+  // Drops the internal resolution of the fullscreen passes when frames run long
+  render::GovernorSettings governorSettings;
+  governorSettings.targetFrameMs = 1000.0f / monitorHz;
+  render::ResolutionGovernor governor(governorSettings);
 
   /** TODO: probably gonna make it part of terrain class in the future  */
-  Shader balatroShader = LoadShader(0, "shaders/ui/balatro.fs");
-  RenderTexture2D target = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
-  
-  int iResolutionLoc = GetShaderLocation(balatroShader, "iResolution");
-  int iTimeLoc = GetShaderLocation(balatroShader, "iTime");
-  float resolution[2] = { (float)GetScreenWidth(), (float)GetScreenHeight() };
-  SetShaderValue(balatroShader, iResolutionLoc, resolution, SHADER_UNIFORM_VEC2);
+  render::BackgroundRenderer background;
+  background.Load();
   /**  */
 
   Game game = Game();
-  game.InitGame();
+  game.LoadResources();
+  if (stress.enabled) game.simThread.SetStress(stress);
+
+  // Resume the run suspended at the last quit, or the one asked for. The
+  // suspend file goes once it is used, a crash mid-run does not replay it.
+  if (!stress.enabled) {
+    const char *error = nullptr;
+    if (loadPath) {
+      if (!game.LoadState(loadPath, &error)) TraceLog(LOG_WARNING, "Could not load %s: %s", loadPath, error);
+    } else if (FileExists(SAVE_FILE)) {
+      if (!game.LoadState(SAVE_FILE, &error)) TraceLog(LOG_WARNING, "Could not resume %s: %s", SAVE_FILE, error);
+      remove(SAVE_FILE);
+    }
+  }
+  // The simulation runs on its own thread from here on, this one only polls
+  // input and renders its snapshots
+  game.Start();
+
+  // F3 toggles it, the history is dumped to PROFILE_FILE on exit either way
+  static ui::ProfilerOverlay profilerOverlay;
+  // Every pass of the frame is recorded into it and submitted in one go
+  render::CommandBuffer commands;
+  // Merged composite (F5): the 3D pass renders here and the UI post pass draws
+  // background, scene and HUD in one go. Needs AMORTIZED background keyframes.
+  render::RenderTextureHandle sceneTarget;
+
+  // Pressed-key state only lasts until the next poll, so everything that reads
+  // it runs exactly once after each one
+  auto onPoll = [&]() {
+    game.HandleInput();
+    profilerOverlay.HandleInput();
+    if (IsKeyPressed(KEY_F4)) {
+      bool amortized = background.settings.mode == render::BackgroundMode::AMORTIZED;
+      background.settings.mode = amortized ? render::BackgroundMode::EVERY_FRAME : render::BackgroundMode::AMORTIZED;
+      background.Invalidate();
+    }
+    if (IsKeyPressed(KEY_F5)) mergedComposite = !mergedComposite;
+  };
+  double nextFrame = GetTime();
+
+  // Stress runs end on their own and report every frame
+  std::vector<float> stressFrameMs, stressWorkMs;
+  double stressEnd = GetTime() + stress.seconds;
+  float perfectsOwed = 0.0f;
+  if (stress.enabled) {
+    stressFrameMs.reserve((size_t)(stress.seconds * monitorHz * 2));
+    stressWorkMs.reserve((size_t)(stress.seconds * monitorHz * 2));
+  }
 
   while (!WindowShouldClose()) {
-    float dt = GetFrameTime();
-    float time = (float)GetTime();
+    // Everything allocated from the arena last frame is dead by now
+    util::FrameArena::Instance().Reset();
+    commands.Begin();
+    double frameStart = GetTime();
+    {
+      PROFILE_SCOPE(util::PHASE_FRAME);
+      double time = GetTime();
+
+      if (stress.enabled) {
+        for (perfectsOwed += stress.perfectsPerSecond * GetFrameTime(); perfectsOwed >= 1.0f; perfectsOwed -= 1.0f) {
+          game.uiManager.SpawnPerfect();
+        }
+      }
+
+      game.Update(GetFrameTime());
+
+      float scale = governor.Update(GetFrameTime() * 1000.0f);
+      game.uiManager.SetResolutionScale(scale);
 
-    game.Update(dt);
-    SetShaderValue(balatroShader, iTimeLoc, &time, SHADER_UNIFORM_FLOAT);
+      BeginDrawing();
+        ClearBackground(RAYWHITE);
 
-    BeginDrawing();
-      ClearBackground(RAYWHITE);
+        bool merged = mergedComposite && background.settings.mode == render::BackgroundMode::AMORTIZED;
+        if (!merged) {
+          sceneTarget.Reset();
+        } else if (!sceneTarget.IsValid() || sceneTarget.Get().texture.width != GetScreenWidth() ||
+                   sceneTarget.Get().texture.height != GetScreenHeight()) {
+          // Only on entering merged mode or a resize. Released first, so the
+          // resize reallocates it in place.
+          sceneTarget.Reset();
+          sceneTarget = render::ResourceCache::Instance().AcquireRenderTexture("scene", GetScreenWidth(), GetScreenHeight());
+        }
+        commands.SetTarget(render::RenderPass::OPAQUE_3D, merged ? &sceneTarget.Get() : nullptr);
+        game.uiManager.SetBackdrop(merged ? &background : nullptr, merged ? sceneTarget.Get().texture : Texture2D{});
 
-      BeginShaderMode(balatroShader);
-        DrawTextureRec(target.texture, 
-                        (Rectangle){ 0, 0, (float)target.texture.width, (float)-target.texture.height }, 
-                        (Vector2){ 0, 0 }, WHITE);
-      EndShaderMode();
+        commands.Custom(render::RenderPass::BACKGROUND, [&background, time, scale, merged] {
+          PROFILE_SCOPE(util::PHASE_BACKGROUND);
+          // Merged, only the keyframes are kept up to date, the composite draws them
+          if (merged) background.Update(time, scale);
+          else background.Draw(time, scale);
+        });
+        game.Render(commands);
+        commands.Submit();
 
-      game.Render(dt);
+        DrawFPS(10, 10);
+        profilerOverlay.Draw(10, 40, commands.Stats());
 
-      DrawFPS(10, 10);
-    EndDrawing();
+      // raylib exposes no GPU timer queries; the GPU cost shows up here, where
+      // the driver blocks on swap (raylib's own frame pacing included)
+      {
+        PROFILE_SCOPE(util::PHASE_PRESENT);
+        EndDrawing();
+      }
+      onPoll();
+    }
+    util::Profiler::Instance().EndFrame();
+
+    if (stress.enabled) {
+      stressFrameMs.push_back(GetFrameTime() * 1000.0f);
+      stressWorkMs.push_back((float)((GetTime() - frameStart) * 1000.0));
+      if (GetTime() >= stressEnd) break;
+    }
+
+    // Idle time is left out of the profile on purpose
+    if (pacing == PACING_SLEEP) {
+      // After a hitch catch up by one frame at most, then keep counting from there
+      nextFrame = fmax(nextFrame + frameBudget, GetTime() - frameBudget);
+      SleepUntil(nextFrame, onPoll);
+    }
   }
 
   // cleanups
-  UnloadShader(balatroShader);
-  UnloadRenderTexture(target);
+  game.Stop();
+  // Quitting mid-run suspends it, the next start picks it up again
+  if (!stress.enabled && game.simThread.State() == sim::PLAYING_STATE && !game.SaveState(SAVE_FILE)) {
+    TraceLog(LOG_WARNING, "Could not write %s", SAVE_FILE);
+  }
+  if (stress.enabled) PrintStressReport(stress, stressFrameMs, stressWorkMs);
+  if (!util::Profiler::Instance().WriteCsv(PROFILE_FILE)) {
+    TraceLog(LOG_WARNING, "Could not write %s", PROFILE_FILE);
+  }
+  game.UnloadResources();
+  sceneTarget.Reset();
+  background.Unload();
+  // The UI canvas and post shader are still referenced by game, everything
+  // has to go before the GL context does
+  render::ResourceCache::Instance().UnloadAll();
   CloseWindow();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "render/background_renderer.h"
+#include "rlgl.h"
+#include <cmath>
+#include <utility>
+
+namespace render {
+
+static const char *SLOT_NAMES[3] = { "background_key0", "background_key1", "background_key2" };
+
+void BackgroundRenderer::Load() {
+  material.Load();
+  // The shader only needs texture coordinates, raylib's 1x1 white texture will do
+  quadTexture = { rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+  // Stays at window size whatever the pass resolution, so the pattern does not change with it
+  material.iResolution.Set({ (float)GetScreenWidth(), (float)GetScreenHeight() });
+  keyIndex = -1;
+}
+
+void BackgroundRenderer::Unload() {
+  for (RenderTextureHandle& slot : slots) slot.Reset();
+  material.Unload();
+}
+
+void BackgroundRenderer::Draw(double time, float scale) {
+  if (settings.mode == BackgroundMode::EVERY_FRAME) {
+    bandsLastFrame = 0;
+    DrawEveryFrame(time, scale);
+    return;
+  }
+
+  Update(time, scale);
+
+  // Blend the two finished keyframes
+  Rectangle screen = { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() };
+  DrawFullscreenQuad(slots[0].Get().texture, screen, true);
+  Rectangle source = { 0, 0, (float)width, -(float)height };
+  DrawTexturePro(slots[1].Get().texture, source, screen, { 0, 0 }, 0.0f, Fade(WHITE, blend));
+}
+
+void BackgroundRenderer::Update(double time, float scale) {
+  bandsLastFrame = 0;
+  int w = (int)(GetScreenWidth() * scale + 0.5f);
+  int h = (int)(GetScreenHeight() * scale + 0.5f);
+  int64_t key = (int64_t)floor(time / settings.keyframeInterval);
+
+  // 1. Resolution change, first frame or a hitch longer than a keyframe: start over
+  if (w != width || h != height || keyIndex < 0 || key > keyIndex + 1 || key < keyIndex) {
+    width = w;
+    height = h;
+    // Slots are swapped around, all of them let go before any is resized
+    for (int i = 0; i < 3; i++) slots[i].Reset();
+    for (int i = 0; i < 3; i++) {
+      slots[i] = ResourceCache::Instance().AcquireRenderTexture(SLOT_NAMES[i], width, height);
+      SetTextureFilter(slots[i].Get().texture, TEXTURE_FILTER_BILINEAR);
+    }
+    Prime(key);
+  } else if (key == keyIndex + 1) {
+    // 2. Crossed into the next interval: finish k+2 and shift everything down
+    RenderBands(slots[2], keyIndex + 2, bandsDone, settings.bands);
+    std::swap(slots[0], slots[1]);
+    std::swap(slots[1], slots[2]);
+    keyIndex = key;
+    bandsDone = 0;
+  }
+
+  // 3. Spread the next keyframe's bands evenly over the interval
+  double progress = time / settings.keyframeInterval - (double)keyIndex;
+  int due = (int)ceil(progress * settings.bands);
+  if (due < 1) due = 1;
+  if (due > settings.bands) due = settings.bands;
+  if (due > bandsDone) {
+    RenderBands(slots[2], keyIndex + 2, bandsDone, due);
+    bandsDone = due;
+  }
+  blend = (float)progress;
+}
+
+void BackgroundRenderer::DrawEveryFrame(double time, float scale) {
+  material.iTime.Set((float)time);
+
+  Vector2 size = directTarget.Begin(scale);
+    BeginShaderMode(material.shader);
+      DrawFullscreenQuad(quadTexture, { 0, 0, size.x, size.y }, true);
+    EndShaderMode();
+  directTarget.End();
+  directTarget.Draw();
+  bandsLastFrame = settings.bands;
+}
+
+void BackgroundRenderer::Prime(int64_t key) {
+  keyIndex = key;
+  RenderBands(slots[0], key, 0, settings.bands);
+  RenderBands(slots[1], key + 1, 0, settings.bands);
+  bandsDone = 0;
+}
+
+void BackgroundRenderer::RenderBands(const RenderTextureHandle& slot, int64_t key, int firstBand, int endBand) {
+  if (firstBand >= endBand) return;
+
+  // Every band of a keyframe shares its time; EndTextureMode below flushes the
+  // batch before the uniform can change again
+  material.iTime.Set((float)((double)key * settings.keyframeInterval));
+
+  // Texture coordinates run 1 -> 0 from top to bottom, same as a full quad
+  float top = (float)firstBand / settings.bands;
+  float bottom = (float)endBand / settings.bands;
+  Rectangle source = { 0, 1.0f - bottom, 1, -(bottom - top) };
+  Rectangle dest = { 0, top * height, (float)width, (bottom - top) * height };
+
+  BeginTextureMode(slot.Get());
+    BeginShaderMode(material.shader);
+      DrawTexturePro(quadTexture, source, dest, { 0, 0 }, 0.0f, WHITE);
+    EndShaderMode();
+  EndTextureMode();
+
+  bandsLastFrame += endBand - firstBand;
+}
+
+}
@@ -0,0 +1,55 @@
+#include "render/block_renderer.h"
+#include "raymath.h"
+
+namespace render {
+
+static void PackColor(Matrix& transform, math::Color color) {
+  transform.m3  = color.r / 255.0f;
+  transform.m7  = color.g / 255.0f;
+  transform.m11 = color.b / 255.0f;
+}
+
+void BlockRenderer::BindInstancing(Shader& shader) {
+  shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+  shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+}
+
+void BlockRenderer::Begin() {
+  util::Renew(instances, lastCount);
+}
+
+void BlockRenderer::Submit(Vector3 position, Vector3 size, math::Color color) {
+  // Axis aligned blocks skip the full SRT multiply
+  Matrix transform = MatrixIdentity();
+  transform.m0  = size.x;
+  transform.m5  = size.y;
+  transform.m10 = size.z;
+  transform.m12 = position.x;
+  transform.m13 = position.y;
+  transform.m14 = position.z;
+
+  PackColor(transform, color);
+  instances.push_back(transform);
+}
+
+void BlockRenderer::Submit(Vector3 position, Vector3 size, Vector3 rotation, math::Color color) {
+  // Combine: Scale -> Rotate -> Translate (SRT Order)
+  auto scale     = MatrixScale(size.x, size.y, size.z);
+  auto rotate    = MatrixRotateXYZ(rotation);
+  auto translate = MatrixTranslate(position.x, position.y, position.z);
+  Matrix transform = MatrixMultiply(scale, MatrixMultiply(rotate, translate));
+
+  PackColor(transform, color);
+  instances.push_back(transform);
+}
+
+void BlockRenderer::Flush(const Mesh& mesh, const Material& material, CommandBuffer& commands) {
+  lastCount = instances.size();
+  if (instances.empty()) {
+    return;
+  }
+
+  commands.DrawMeshInstanced(RenderPass::OPAQUE_3D, mesh, material, instances.data(), (int)instances.size());
+}
+
+}
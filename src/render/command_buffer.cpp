@@ -0,0 +1,223 @@
+#include "render/command_buffer.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "util/profiler.h"
+#include <algorithm>
+#include <cstring>
+
+namespace render {
+
+// Sort key layout, high to low bits
+static const int PASS_SHIFT = 60;
+static const int SHADER_SHIFT = 48;   // 12 bits
+static const int TEXTURE_SHIFT = 36;  // 12 bits
+static const int MESH_SHIFT = 20;     // 16 bits
+static const uint64_t INDEX_MASK = COMMAND_BUFFER_MAX - 1;
+
+// raylib keeps a mesh's index buffer in the last of its vertex buffers
+static const int MESH_INDEX_BUFFER = 6;
+
+static RenderPass PassOf(uint64_t key) {
+  return (RenderPass)(key >> PASS_SHIFT);
+}
+
+void CommandBuffer::Begin() {
+  util::Renew(commands, lastCount);
+  util::Renew(keys, lastCount);
+}
+
+void CommandBuffer::SetTarget(RenderPass pass, const RenderTexture2D *target) {
+  targets[(int)pass] = target ? *target : RenderTexture2D{};
+}
+
+void CommandBuffer::Record(RenderPass pass, const Command& command, unsigned int shader, unsigned int texture, unsigned int mesh) {
+  if (commands.size() >= COMMAND_BUFFER_MAX) {
+    TraceLog(LOG_WARNING, "Command buffer full, dropping draw");
+    return;
+  }
+
+  uint64_t key = (uint64_t)pass << PASS_SHIFT | commands.size();
+  if (pass == RenderPass::OPAQUE_3D) {
+    // Truncated ids only weaken the grouping, the command keeps the real ones
+    key |= (uint64_t)(shader & 0xFFF) << SHADER_SHIFT;
+    key |= (uint64_t)(texture & 0xFFF) << TEXTURE_SHIFT;
+    key |= (uint64_t)(mesh & 0xFFFF) << MESH_SHIFT;
+  }
+
+  commands.push_back(command);
+  keys.push_back(key);
+}
+
+void CommandBuffer::DrawMesh(RenderPass pass, const Mesh& mesh, const Material& material, Matrix transform) {
+  Command command = {};
+  command.type = Command::MESH;
+  command.mesh = &mesh;
+  command.material = material;
+  command.transform = transform;
+  Record(pass, command, material.shader.id, material.maps[MATERIAL_MAP_DIFFUSE].texture.id, mesh.vaoId);
+}
+
+void CommandBuffer::DrawMeshInstanced(RenderPass pass, const Mesh& mesh, const Material& material, const Matrix *transforms, int instances) {
+  if (instances <= 0) return;
+
+  Command command = {};
+  command.type = Command::INSTANCED;
+  command.mesh = &mesh;
+  command.material = material;
+  command.transforms = transforms;
+  command.instances = instances;
+  Record(pass, command, material.shader.id, material.maps[MATERIAL_MAP_DIFFUSE].texture.id, mesh.vaoId);
+}
+
+void CommandBuffer::Submit() {
+  stats = {};
+  stats.commands = commands.size();
+  lastCount = commands.size();
+
+  std::sort(keys.begin(), keys.end());
+
+  size_t first = 0;
+  for (int p = 0; p < (int)RenderPass::COUNT; p++) {
+    RenderPass pass = (RenderPass)p;
+    size_t end = first;
+    while (end < keys.size() && PassOf(keys[end]) == pass) end++;
+
+    // A pass with a target clears it even when empty, it is read later on
+    const RenderTexture2D& target = targets[p];
+    if (target.id != 0) {
+      BeginTextureMode(target);
+      ClearBackground(BLANK);
+    }
+
+    if (pass == RenderPass::OPAQUE_3D && end > first) {
+      PROFILE_SCOPE(util::PHASE_RENDER_3D);
+      BeginMode3D(camera);
+        SubmitRange(first, end);
+      EndMode3D();
+    } else {
+      SubmitRange(first, end);
+    }
+
+    if (target.id != 0) EndTextureMode();
+    first = end;
+  }
+}
+
+void CommandBuffer::SubmitRange(size_t first, size_t end) {
+  for (size_t k = first; k < end; k++) {
+    const Command& command = commands[keys[k] & INDEX_MASK];
+
+    switch (command.type) {
+      case Command::MESH:
+        SubmitMesh(command);
+        break;
+
+      case Command::INSTANCED:
+        // raylib binds and releases everything itself
+        Unbind();
+        ::DrawMeshInstanced(*command.mesh, command.material, command.transforms, command.instances);
+        stats.drawCalls++;
+        stats.shaderChanges++;
+        stats.textureChanges++;
+        stats.meshChanges++;
+        break;
+
+      case Command::CUSTOM:
+        // rlgl's batch expects nothing bound
+        Unbind();
+        command.invoke(command.data);
+        stats.customs++;
+        break;
+    }
+  }
+
+  Unbind();
+}
+
+void CommandBuffer::SubmitMesh(const Command& command) {
+  const Mesh& mesh = *command.mesh;
+  const Material& material = command.material;
+  const MaterialMap& diffuse = material.maps[MATERIAL_MAP_DIFFUSE];
+  int *locs = material.shader.locs;
+
+  // Without a vertex array object raylib binds every buffer by hand
+  if (mesh.vaoId == 0) {
+    Unbind();
+    ::DrawMesh(mesh, material, command.transform);
+    stats.drawCalls++;
+    stats.shaderChanges++;
+    stats.textureChanges++;
+    stats.meshChanges++;
+    return;
+  }
+
+  // 1. Shader, the camera matrices go with it, then the material color
+  if (bound.shader != material.shader.id) {
+    rlEnableShader(material.shader.id);
+    bound.shader = material.shader.id;
+    bound.texture = 0;
+    bound.hasColor = false;
+    bound.hasTransform = false;
+    stats.shaderChanges++;
+
+    bound.view = rlGetMatrixModelview();
+    bound.projection = rlGetMatrixProjection();
+    if (locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_VIEW], bound.view);
+    if (locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_PROJECTION], bound.projection);
+  }
+
+  if (!bound.hasColor || memcmp(&bound.color, &diffuse.color, sizeof(Color)) != 0) {
+    if (locs[SHADER_LOC_COLOR_DIFFUSE] != -1) {
+      float color[4] = { diffuse.color.r / 255.0f, diffuse.color.g / 255.0f, diffuse.color.b / 255.0f, diffuse.color.a / 255.0f };
+      rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], color, RL_SHADER_UNIFORM_VEC4, 1);
+    }
+    bound.color = diffuse.color;
+    bound.hasColor = true;
+  }
+
+  // 2. Diffuse texture on slot 0
+  if (bound.texture != diffuse.texture.id) {
+    int slot = 0;
+    rlActiveTextureSlot(slot);
+    rlEnableTexture(diffuse.texture.id);
+    if (locs[SHADER_LOC_MAP_DIFFUSE] != -1) rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+    bound.texture = diffuse.texture.id;
+    stats.textureChanges++;
+  }
+
+  // 3. Model matrices, baked chunks all share the identity
+  if (!bound.hasTransform || memcmp(&bound.transform, &command.transform, sizeof(Matrix)) != 0) {
+    Matrix model = MatrixMultiply(command.transform, rlGetMatrixTransform());
+    if (locs[SHADER_LOC_MATRIX_MODEL] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MODEL], model);
+    if (locs[SHADER_LOC_MATRIX_NORMAL] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_NORMAL], MatrixTranspose(MatrixInvert(model)));
+    Matrix mvp = MatrixMultiply(MatrixMultiply(model, bound.view), bound.projection);
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+
+    bound.transform = command.transform;
+    bound.hasTransform = true;
+  }
+
+  // 4. Vertex array and the draw. Meshes whose CPU copy of the indices was
+  //    dropped after upload still have their index buffer.
+  if (bound.vertexArray != mesh.vaoId) {
+    rlEnableVertexArray(mesh.vaoId);
+    bound.vertexArray = mesh.vaoId;
+    stats.meshChanges++;
+  }
+
+  if (mesh.vboId[MESH_INDEX_BUFFER] != 0) rlDrawVertexArrayElements(0, mesh.triangleCount * 3, 0);
+  else rlDrawVertexArray(0, mesh.vertexCount);
+  stats.drawCalls++;
+}
+
+void CommandBuffer::Unbind() {
+  if (bound.vertexArray != 0) rlDisableVertexArray();
+  if (bound.texture != 0) {
+    rlActiveTextureSlot(0);
+    rlDisableTexture();
+  }
+  if (bound.shader != 0) rlDisableShader();
+  bound = Bound();
+}
+
+}
@@ -0,0 +1,50 @@
+#include "render/material.h"
+#include "render/block_renderer.h"
+
+namespace render {
+
+void ShaderMaterial::LoadShaderFiles(const char *vsFileName, const char *fsFileName) {
+  handle = ResourceCache::Instance().AcquireShader(vsFileName, fsFileName);
+  shader = handle.Get();
+}
+
+void ShaderMaterial::Unload() {
+  // The cache frees the program itself on shutdown
+  handle.Reset();
+  shader = {};
+}
+
+void LightingMaterial::Load(LightingVariant variant) {
+  if (variant == LightingVariant::INSTANCED) {
+    LoadShaderFiles("shaders/3d/lighting_instanced_vertex.glsl", "shaders/3d/lighting_fragment.glsl");
+    BlockRenderer::BindInstancing(shader);
+  } else {
+    LoadShaderFiles("shaders/3d/lighting_vertex.glsl", "shaders/3d/lighting_fragment.glsl");
+    blockColor.Bind(shader, "blockColor");
+  }
+
+  cameraPosition.Bind(shader, "cameraPosition");
+}
+
+void PostMaterial::Load() {
+  LoadShaderFiles(0, "shaders/ui/ui_post.glsl");
+  effectIntensity.Bind(shader, "effectIntensity");
+  time.Bind(shader, "time");
+}
+
+void CompositeMaterial::Load() {
+  LoadShaderFiles(0, "shaders/ui/ui_composite.fs");
+  scene.Bind(shader, "scene");
+  background0.Bind(shader, "background0");
+  background1.Bind(shader, "background1");
+  backgroundBlend.Bind(shader, "backgroundBlend");
+  effectIntensity.Bind(shader, "effectIntensity");
+}
+
+void BackgroundMaterial::Load() {
+  LoadShaderFiles(0, "shaders/ui/balatro.fs");
+  iTime.Bind(shader, "iTime");
+  iResolution.Bind(shader, "iResolution");
+}
+
+}
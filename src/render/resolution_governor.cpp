@@ -0,0 +1,51 @@
+#include "render/resolution_governor.h"
+#include <algorithm>
+
+namespace render {
+
+ResolutionGovernor::ResolutionGovernor(GovernorSettings settings)
+  : settings(settings), scale(settings.maxScale), average(settings.targetFrameMs), probeInterval(settings.probeFrames) {}
+
+float ResolutionGovernor::Update(float frameMs) {
+  // Single hitches (loading, window moves) should not cost resolution
+  frameMs = std::min(frameMs, settings.targetFrameMs * 4.0f);
+  average += (frameMs - average) * settings.smoothing;
+  framesSinceRaise++;
+
+  if (average > settings.targetFrameMs * settings.overBudget) {
+    overFrames++;
+    comfortableFrames = 0;
+  } else {
+    overFrames = 0;
+    if (average < settings.targetFrameMs * settings.onBudget) comfortableFrames++;
+  }
+
+  // 1. Sustained overrun: drop a step
+  if (overFrames >= settings.dropFrames && scale > settings.minScale) {
+    scale = std::max(settings.minScale, scale - settings.scaleStep);
+    overFrames = 0;
+    comfortableFrames = 0;
+    // The probe that got us here failed, wait longer before the next one
+    if (justRaised && framesSinceRaise < probeInterval) {
+      probeInterval = std::min(probeInterval * 2, settings.maxProbeFrames);
+    }
+    justRaised = false;
+    // Let the average settle on the new cost
+    average = settings.targetFrameMs;
+    return scale;
+  }
+
+  // 2. Long comfortable stretch: probe one step up
+  if (comfortableFrames >= probeInterval && scale < settings.maxScale) {
+    // The last raise held up, the next probe can come sooner again
+    if (justRaised) probeInterval = std::max(settings.probeFrames, probeInterval / 2);
+    scale = std::min(settings.maxScale, scale + settings.scaleStep);
+    comfortableFrames = 0;
+    framesSinceRaise = 0;
+    justRaised = true;
+  }
+
+  return scale;
+}
+
+}
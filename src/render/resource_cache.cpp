@@ -0,0 +1,88 @@
+#include "render/resource_cache.h"
+
+namespace render {
+
+ResourceCache& ResourceCache::Instance() {
+  static ResourceCache cache;
+  return cache;
+}
+
+template <typename T>
+CachedResource<T> *ResourceCache::Find(std::unordered_map<std::string, std::unique_ptr<CachedResource<T>>>& map, const std::string& key) {
+  auto& slot = map[key];
+  if (!slot) slot = std::make_unique<CachedResource<T>>();
+  return slot.get();
+}
+
+ShaderHandle ResourceCache::AcquireShader(const char *vsFileName, const char *fsFileName) {
+  std::string key = std::string(vsFileName ? vsFileName : "") + "|" + (fsFileName ? fsFileName : "");
+  CachedResource<Shader> *entry = Find(shaders, key);
+
+  if (!entry->loaded) {
+    entry->resource = LoadShader(vsFileName, fsFileName);
+    entry->loaded = true;
+  }
+  return ShaderHandle(entry);
+}
+
+MeshHandle ResourceCache::AcquireMesh(const char *name, const std::function<Mesh()>& generate) {
+  CachedResource<Mesh> *entry = Find(meshes, name);
+
+  if (!entry->loaded) {
+    // raylib's GenMesh* functions upload to the GPU already
+    entry->resource = generate();
+    entry->loaded = true;
+  }
+  return MeshHandle(entry);
+}
+
+RenderTextureHandle ResourceCache::AcquireRenderTexture(const char *name, int width, int height) {
+  CachedResource<RenderTexture2D> *entry = Find(renderTextures, name);
+  auto sizeDiffers = [&](const CachedResource<RenderTexture2D> *cached) {
+    return cached->loaded && (cached->resource.texture.width != width || cached->resource.texture.height != height);
+  };
+
+  // Holders keep the RenderTexture2D by value, it must never change under
+  // them: while anyone still holds it, another size gets its own entry
+  if (sizeDiffers(entry) && entry->refs > 0) {
+    entry = Find(renderTextures, std::string(name) + "@" + std::to_string(width) + "x" + std::to_string(height));
+  }
+
+  // A size change (window resize, resolution scaling) replaces the texture
+  if (sizeDiffers(entry)) {
+    UnloadRenderTexture(entry->resource);
+    entry->loaded = false;
+  }
+
+  if (!entry->loaded) {
+    entry->resource = LoadRenderTexture(width, height);
+    entry->loaded = true;
+  }
+  return RenderTextureHandle(entry);
+}
+
+void ResourceCache::UnloadUnused() {
+  for (auto& pair : shaders) {
+    if (pair.second->loaded && pair.second->refs == 0) { UnloadShader(pair.second->resource); pair.second->loaded = false; }
+  }
+  for (auto& pair : meshes) {
+    if (pair.second->loaded && pair.second->refs == 0) { UnloadMesh(pair.second->resource); pair.second->loaded = false; }
+  }
+  for (auto& pair : renderTextures) {
+    if (pair.second->loaded && pair.second->refs == 0) { UnloadRenderTexture(pair.second->resource); pair.second->loaded = false; }
+  }
+}
+
+void ResourceCache::UnloadAll() {
+  for (auto& pair : shaders) {
+    if (pair.second->loaded) { UnloadShader(pair.second->resource); pair.second->loaded = false; }
+  }
+  for (auto& pair : meshes) {
+    if (pair.second->loaded) { UnloadMesh(pair.second->resource); pair.second->loaded = false; }
+  }
+  for (auto& pair : renderTextures) {
+    if (pair.second->loaded) { UnloadRenderTexture(pair.second->resource); pair.second->loaded = false; }
+  }
+}
+
+}
@@ -0,0 +1,49 @@
+#include "render/scaled_target.h"
+#include "rlgl.h"
+
+namespace render {
+
+Vector2 ScaledTarget::Begin(float scale) {
+  Vector2 size = { (float)GetScreenWidth(), (float)GetScreenHeight() };
+  scaled = scale < 1.0f;
+  if (!scaled) {
+    handle.Reset();
+    return size;
+  }
+
+  int width = (int)(size.x * scale + 0.5f);
+  int height = (int)(size.y * scale + 0.5f);
+  // The cache reallocates only when the size actually changes, and only in
+  // place once this handle let go of it
+  handle.Reset();
+  handle = ResourceCache::Instance().AcquireRenderTexture(name, width, height);
+  target = handle.Get();
+  SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+
+  BeginTextureMode(target);
+  ClearBackground(BLANK);
+  // Write color and alpha untouched, blending happens once in Draw()
+  rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+  BeginBlendMode(BLEND_CUSTOM);
+  return { (float)width, (float)height };
+}
+
+void ScaledTarget::End() {
+  if (!scaled) return;
+
+  EndBlendMode();
+  EndTextureMode();
+}
+
+void ScaledTarget::Draw() {
+  if (!scaled) return;
+
+  DrawFullscreenQuad(target.texture, { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() }, true);
+}
+
+void DrawFullscreenQuad(Texture2D source, Rectangle rect, bool flipY) {
+  Rectangle sourceRect = { 0, 0, (float)source.width, flipY ? -(float)source.height : (float)source.height };
+  DrawTexturePro(source, sourceRect, rect, { 0, 0 }, 0.0f, WHITE);
+}
+
+}
@@ -0,0 +1,174 @@
+#include "render/tower_chunks.h"
+#include "raymath.h"
+#include <algorithm>
+
+namespace render {
+
+// Face normals and the four corners (in half-size units) of each cube face,
+// wound counter-clockwise when seen from outside
+static const float FACE_NORMALS[6][3] = {
+  { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, 0, 0 }, { -1, 0, 0 }
+};
+
+static const float FACE_CORNERS[6][4][3] = {
+  { { -1, -1,  1 }, {  1, -1,  1 }, {  1,  1,  1 }, { -1,  1,  1 } },
+  { { -1, -1, -1 }, { -1,  1, -1 }, {  1,  1, -1 }, {  1, -1, -1 } },
+  { { -1,  1, -1 }, { -1,  1,  1 }, {  1,  1,  1 }, {  1,  1, -1 } },
+  { { -1, -1, -1 }, {  1, -1, -1 }, {  1, -1,  1 }, { -1, -1,  1 } },
+  { {  1, -1, -1 }, {  1,  1, -1 }, {  1,  1,  1 }, {  1, -1,  1 } },
+  { { -1, -1, -1 }, { -1, -1,  1 }, { -1,  1,  1 }, { -1,  1, -1 } }
+};
+
+TowerChunk TowerChunks::Bake(const entity::TowerStore& blocks, size_t first) {
+  const int verticesPerBlock = 24;
+  const int indicesPerBlock = 36;
+  const int count = (int)TOWER_CHUNK_SIZE;
+
+  TowerChunk chunk = {};
+  chunk.firstBlock = first;
+  chunk.boundsMin = blocks.Get(first).position;
+  chunk.boundsMax = chunk.boundsMin;
+
+  Mesh& mesh = chunk.mesh;
+  mesh.vertexCount = count * verticesPerBlock;
+  mesh.triangleCount = count * indicesPerBlock / 3;
+  // UnloadMesh releases these with RL_FREE, so they must come from MemAlloc
+  mesh.vertices = (float *)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+  mesh.normals = (float *)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+  mesh.colors = (unsigned char *)MemAlloc(mesh.vertexCount * 4 * sizeof(unsigned char));
+
+  // Every full chunk has the same index pattern, one copy serves all of them
+  if (indices.empty()) {
+    indices.reserve(count * indicesPerBlock);
+    for (int quad = 0; quad < count * 6; quad++) {
+      unsigned short base = (unsigned short)(quad * 4);
+      // Two triangles per face
+      indices.insert(indices.end(), { base, (unsigned short)(base + 1), (unsigned short)(base + 2),
+                                      base, (unsigned short)(base + 2), (unsigned short)(base + 3) });
+    }
+  }
+  mesh.indices = indices.data();
+
+  int v = 0;
+  for (size_t b = first; b < first + TOWER_CHUNK_SIZE; b++) {
+    entity::Block block = blocks.Get(b);
+    Vector3 half = Vector3Scale(block.size, 0.5f);
+
+    chunk.boundsMin = Vector3Min(chunk.boundsMin, Vector3Subtract(block.position, half));
+    chunk.boundsMax = Vector3Max(chunk.boundsMax, Vector3Add(block.position, half));
+
+    for (int face = 0; face < 6; face++) {
+      for (int corner = 0; corner < 4; corner++) {
+        mesh.vertices[v*3 + 0] = block.position.x + FACE_CORNERS[face][corner][0] * half.x;
+        mesh.vertices[v*3 + 1] = block.position.y + FACE_CORNERS[face][corner][1] * half.y;
+        mesh.vertices[v*3 + 2] = block.position.z + FACE_CORNERS[face][corner][2] * half.z;
+
+        mesh.normals[v*3 + 0] = FACE_NORMALS[face][0];
+        mesh.normals[v*3 + 1] = FACE_NORMALS[face][1];
+        mesh.normals[v*3 + 2] = FACE_NORMALS[face][2];
+
+        mesh.colors[v*4 + 0] = block.color.r;
+        mesh.colors[v*4 + 1] = block.color.g;
+        mesh.colors[v*4 + 2] = block.color.b;
+        mesh.colors[v*4 + 3] = block.color.a;
+        v++;
+      }
+    }
+  }
+
+  UploadMesh(&mesh, false);
+
+  // The GPU has its own copy and static chunks are never updated, drop ours
+  // so very tall towers do not keep every vertex twice. The shared indices
+  // stay: raylib's DrawMesh only draws indexed while mesh.indices is set.
+  MemFree(mesh.vertices);
+  MemFree(mesh.normals);
+  MemFree(mesh.colors);
+  mesh.vertices = nullptr;
+  mesh.normals = nullptr;
+  mesh.colors = nullptr;
+  return chunk;
+}
+
+void TowerChunks::Sync(const entity::TowerStore& blocks) {
+  while (blocks.Size() >= BakedCount() + TOWER_CHUNK_SIZE) {
+    TowerChunk chunk = Bake(blocks, BakedCount());
+
+    if (chunks.empty()) {
+      footprintMin = chunk.boundsMin;
+      footprintMax = chunk.boundsMax;
+    } else {
+      footprintMin = Vector3Min(footprintMin, chunk.boundsMin);
+      footprintMax = Vector3Max(footprintMax, chunk.boundsMax);
+    }
+
+    chunks.push_back(chunk);
+  }
+}
+
+// Offset of a box center along a view axis, radius receives the box's half length on it
+static float ProjectBox(Vector3 center, Vector3 halfExtents, Vector3 origin, Vector3 axis, float *radius) {
+  *radius = fabsf(axis.x) * halfExtents.x + fabsf(axis.y) * halfExtents.y + fabsf(axis.z) * halfExtents.z;
+  return Vector3DotProduct(Vector3Subtract(center, origin), axis);
+}
+
+void TowerChunks::Draw(const Camera3D& camera, float aspect, const Material& material, CommandBuffer& commands) {
+  visibleCount = 0;
+  if (chunks.empty()) return;
+
+  // Orthographic view volume: fovy is the full view height in world units
+  Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+  Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+  Vector3 up = Vector3CrossProduct(right, forward);
+  float halfHeight = camera.fovy * 0.5f;
+  float halfWidth = halfHeight * aspect;
+
+  // 1. Narrow down to a Y range using the tower footprint. Chunks are sorted
+  //    bottom to top, so the visible ones form a contiguous slice.
+  size_t begin = 0;
+  size_t end = chunks.size();
+
+  if (up.y > 0.0001f) {
+    Vector3 footprintCenter = Vector3Scale(Vector3Add(footprintMin, footprintMax), 0.5f);
+    Vector3 footprintHalf = Vector3Scale(Vector3Subtract(footprintMax, footprintMin), 0.5f);
+    footprintCenter.y = camera.position.y;
+    footprintHalf.y = 0;
+
+    float radius;
+    float offset = ProjectBox(footprintCenter, footprintHalf, camera.position, up, &radius);
+    float minY = camera.position.y + (-halfHeight - offset - radius) / up.y;
+    float maxY = camera.position.y + ( halfHeight - offset + radius) / up.y;
+
+    begin = std::lower_bound(chunks.begin(), chunks.end(), minY,
+      [](const TowerChunk& chunk, float y) { return chunk.boundsMax.y < y; }) - chunks.begin();
+    end = std::upper_bound(chunks.begin(), chunks.end(), maxY,
+      [](float y, const TowerChunk& chunk) { return y < chunk.boundsMin.y; }) - chunks.begin();
+  }
+
+  // 2. Exact box test against the sides of the view volume
+  for (size_t c = begin; c < end; c++) {
+    const TowerChunk& chunk = chunks[c];
+    Vector3 center = Vector3Scale(Vector3Add(chunk.boundsMin, chunk.boundsMax), 0.5f);
+    Vector3 half = Vector3Scale(Vector3Subtract(chunk.boundsMax, chunk.boundsMin), 0.5f);
+
+    float radius;
+    if (fabsf(ProjectBox(center, half, camera.position, right, &radius)) - radius > halfWidth) continue;
+    if (fabsf(ProjectBox(center, half, camera.position, up, &radius)) - radius > halfHeight) continue;
+
+    commands.DrawMesh(RenderPass::OPAQUE_3D, chunk.mesh, material, MatrixIdentity());
+    visibleCount++;
+  }
+}
+
+void TowerChunks::Clear() {
+  for (auto& chunk : chunks) {
+    // The indices belong to us, UnloadMesh would RL_FREE them
+    chunk.mesh.indices = nullptr;
+    UnloadMesh(chunk.mesh);
+  }
+
+  chunks.clear();
+  visibleCount = 0;
+}
+
+}
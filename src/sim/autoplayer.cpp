@@ -0,0 +1,60 @@
+#include "sim/autoplayer.h"
+#include <cmath>
+
+namespace sim {
+
+float AutoPlayer::Gaussian() {
+  // Box-Muller, one sample is enough
+  float u1 = fmaxf(random.Float(), 1e-7f);
+  float u2 = random.Float();
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI * u2);
+}
+
+void AutoPlayer::Plan(const Simulation& simulation, float dt) {
+  const entity::Block& target = simulation.GetPreviousBlock();
+  const entity::Movement& movement = *simulation.GetCurrentMovement();
+
+  // 1. The next moment the block lines up with the target, measured from the
+  //    start of the coming step
+  float targetPos = movement.axis == entity::X ? target.position.x : target.position.z;
+  float ideal = movement.TimeUntil(targetPos);
+
+  // 2. Miss the ideal moment like a person would
+  float error = skill.reactionBias + Gaussian() * skill.reactionJitter;
+  if (random.Float() < skill.blunderChance) {
+    error += Gaussian() * skill.blunderJitter;
+  }
+
+  // 3. Split the press time into a step and a position inside it
+  double pressTime = fmax(0.0, (double)ideal + error);
+  double steps = floor(pressTime / dt);
+  pressTick = simulation.tick + (uint64_t)steps;
+  pressSubTick = Input::SubTickFor(pressTime - steps * dt, dt);
+  plannedBlock = simulation.current_block.Id();
+}
+
+Input AutoPlayer::Decide(const Simulation& simulation, float dt) {
+  Input input;
+
+  switch (simulation.state) {
+    case READY_STATE:
+      input.press = true;
+      break;
+
+    case PLAYING_STATE:
+      if (plannedBlock != simulation.current_block.Id()) {
+        Plan(simulation, dt);
+      }
+      input.press = simulation.tick >= pressTick;
+      input.subTick = simulation.tick == pressTick ? pressSubTick : 0;
+      break;
+
+    case GAME_OVER_STATE:
+      break;
+  }
+
+  if (input.press) plannedBlock = entity::INVALID_ENTITY;
+  return input;
+}
+
+}
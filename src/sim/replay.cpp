@@ -0,0 +1,250 @@
+#include "sim/replay.h"
+#include <cstring>
+
+namespace sim {
+
+// Flush once this much has been buffered, writes stay large and rare
+static const size_t REPLAY_FLUSH_SIZE = 64 * 1024;
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((uint8_t)value);
+}
+
+static bool GetVarint(const std::vector<uint8_t>& in, size_t end, size_t& cursor, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (cursor >= end) return false;
+
+    uint8_t byte = in[cursor++];
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+static void HashBytes(uint64_t& hash, const void *data, size_t size) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+}
+
+uint64_t HashTower(const Simulation& simulation) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+
+  const entity::TowerStore& tower = simulation.placed_blocks;
+  for (size_t i = 0; i < tower.Size(); i++) {
+    entity::Block block = tower.Get(i);
+    HashBytes(hash, &block.position, sizeof(block.position));
+    HashBytes(hash, &block.size, sizeof(block.size));
+  }
+  return hash;
+}
+
+// --- Recording ---
+
+void ReplayRecorder::Begin(uint64_t seed, uint32_t tickRate) {
+  run = ReplayRun();
+  run.seed = seed;
+  run.tickRate = tickRate;
+}
+
+const ReplayRun& ReplayRecorder::Finish(const Simulation& simulation) {
+  run.finalTick = simulation.tick;
+  run.score = simulation.Score();
+  run.towerHash = HashTower(simulation);
+  return run;
+}
+
+bool ReplayWriter::Open(const char *path) {
+  Close();
+  file = fopen(path, "ab");
+  buffer.reserve(REPLAY_FLUSH_SIZE * 2);
+  return file != nullptr;
+}
+
+void ReplayWriter::Write(const ReplayRun& run) {
+  if (!file) return;
+
+  // 1. Body
+  record.clear();
+  PutVarint(record, run.seed);
+  PutVarint(record, run.tickRate);
+  PutVarint(record, run.pressTicks.size());
+
+  uint64_t previous = 0;
+  for (size_t i = 0; i < run.pressTicks.size(); i++) {
+    PutVarint(record, run.pressTicks[i] - previous);
+    record.push_back(run.pressSubTicks[i]);
+    previous = run.pressTicks[i];
+  }
+
+  PutVarint(record, run.finalTick - previous);
+  PutVarint(record, run.score);
+  PutVarint(record, run.towerHash);
+
+  // 2. Header, then the body behind it
+  uint32_t magic = REPLAY_MAGIC;
+  const uint8_t *magicBytes = (const uint8_t *)&magic;
+  buffer.insert(buffer.end(), magicBytes, magicBytes + sizeof(magic));
+  buffer.push_back(REPLAY_VERSION);
+  PutVarint(buffer, record.size());
+  buffer.insert(buffer.end(), record.begin(), record.end());
+
+  if (buffer.size() >= REPLAY_FLUSH_SIZE) Flush();
+}
+
+void ReplayWriter::Flush() {
+  if (!file || buffer.empty()) return;
+
+  fwrite(buffer.data(), 1, buffer.size(), file);
+  fflush(file);
+  buffer.clear();
+}
+
+void ReplayWriter::Close() {
+  if (!file) return;
+
+  Flush();
+  fclose(file);
+  file = nullptr;
+}
+
+// --- Reading ---
+
+bool ReplayReader::Open(const char *path) {
+  data.clear();
+  cursor = 0;
+  skipped = 0;
+  error = nullptr;
+
+  FILE *file = fopen(path, "rb");
+  if (!file) return false;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  data.resize(size > 0 ? (size_t)size : 0);
+  size_t read = fread(data.data(), 1, data.size(), file);
+  fclose(file);
+
+  return read == data.size();
+}
+
+bool ReplayReader::Next(ReplayRun& run) {
+  while (!error && cursor < data.size()) {
+    uint32_t magic;
+    if (cursor + sizeof(magic) + 1 > data.size()) return Fail("truncated record");
+
+    memcpy(&magic, &data[cursor], sizeof(magic));
+    if (magic != REPLAY_MAGIC) return Fail("not a replay record");
+    uint8_t version = data[cursor + sizeof(magic)];
+    cursor += sizeof(magic) + 1;
+
+    // 1. Versions 1 to 3 have no length, only their known layouts tell where
+    // they end: 1 has no sub-ticks
+    if (version >= 1 && version <= 3) {
+      if (!ReadRun(data.size(), version >= 2, run)) return false;
+      if (version == 3) return true;
+      skipped++;
+      continue;
+    }
+    if (version == 0) return Fail("unsupported replay version");
+
+    // 2. Anything newer is stepped over by its length if it is not ours
+    uint64_t length;
+    if (!GetVarint(data, data.size(), cursor, length)) return Fail("truncated record");
+    if (length > data.size() - cursor) return Fail("truncated record");
+    size_t end = cursor + (size_t)length;
+
+    if (version != REPLAY_VERSION) {
+      cursor = end;
+      skipped++;
+      continue;
+    }
+    if (!ReadRun(end, true, run)) return false;
+    if (cursor != end) return Fail("bad record length");
+    return true;
+  }
+  return false;
+}
+
+bool ReplayReader::ReadRun(size_t end, bool subTicks, ReplayRun& run) {
+  uint64_t tickRate, pressCount, delta;
+  run = ReplayRun();
+  if (!GetVarint(data, end, cursor, run.seed)) return Fail("truncated record");
+  if (!GetVarint(data, end, cursor, tickRate)) return Fail("truncated record");
+  if (!GetVarint(data, end, cursor, pressCount)) return Fail("truncated record");
+  run.tickRate = (uint32_t)tickRate;
+
+  // Each press takes at least a byte, two with its sub-tick; reject counts
+  // the data cannot hold
+  if (pressCount > (end - cursor) / (subTicks ? 2 : 1)) return Fail("bad press count");
+  run.pressTicks.resize(pressCount);
+  run.pressSubTicks.resize(pressCount);
+
+  uint64_t tick = 0;
+  for (uint64_t i = 0; i < pressCount; i++) {
+    if (!GetVarint(data, end, cursor, delta)) return Fail("truncated record");
+    tick += delta;
+    run.pressTicks[i] = tick;
+
+    if (!subTicks) continue;
+    if (cursor >= end) return Fail("truncated record");
+    run.pressSubTicks[i] = data[cursor++];
+  }
+
+  if (!GetVarint(data, end, cursor, delta)) return Fail("truncated record");
+  run.finalTick = tick + delta;
+  if (!GetVarint(data, end, cursor, run.score)) return Fail("truncated record");
+  if (!GetVarint(data, end, cursor, run.towerHash)) return Fail("truncated record");
+  return true;
+}
+
+// --- Playback ---
+
+void ReplayPlayer::Start(const ReplayRun& run) {
+  this->run = &run;
+  this->nextPress = 0;
+  simulation.Reset(run.seed);
+}
+
+bool ReplayPlayer::Finished() const {
+  return !run || simulation.tick >= run->finalTick;
+}
+
+bool ReplayPlayer::Advance(uint64_t maxTicks) {
+  if (Finished()) return false;
+
+  float dt = 1.0f / run->tickRate;
+  for (uint64_t i = 0; i < maxTicks && !Finished(); i++) {
+    Input input;
+    if (nextPress < run->pressTicks.size() && run->pressTicks[nextPress] == simulation.tick) {
+      input.press = true;
+      input.subTick = run->pressSubTicks[nextPress];
+      nextPress++;
+    }
+
+    simulation.Step(input, dt);
+  }
+
+  return !Finished();
+}
+
+void ReplayPlayer::FastForward(const ReplayRun& run) {
+  Start(run);
+  Advance(run.finalTick);
+}
+
+bool ReplayPlayer::Verify(const ReplayRun& run) {
+  FastForward(run);
+  return simulation.Score() == run.score && HashTower(simulation) == run.towerHash;
+}
+
+}
@@ -0,0 +1,269 @@
+#include "sim/save_state.h"
+#include <cstdio>
+#include <cstring>
+
+namespace sim {
+
+static const size_t SAVE_ALIGNMENT = 8;
+
+static_assert(sizeof(SaveHeader) % SAVE_ALIGNMENT == 0, "sections must start aligned");
+static_assert(sizeof(SaveSection) % SAVE_ALIGNMENT == 0, "the table must end aligned");
+
+uint64_t SaveChecksum(const uint8_t *data, size_t size) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  size_t words = size / sizeof(uint64_t);
+  for (size_t i = 0; i < words; i++) {
+    uint64_t word;
+    memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+    hash ^= word;
+    hash *= 0x100000001B3ull;
+  }
+  for (size_t i = words * sizeof(uint64_t); i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// --- Writing ---
+
+void SaveWriter::Begin() {
+  buffer.assign(sizeof(SaveHeader), 0);
+  sections.clear();
+}
+
+void SaveWriter::AddBytes(uint32_t id, const void *records, size_t recordSize, size_t count) {
+  SaveSection section = { id, (uint32_t)recordSize, buffer.size(), count };
+  sections.push_back(section);
+
+  size_t bytes = recordSize * count;
+  size_t padded = (bytes + SAVE_ALIGNMENT - 1) & ~(SAVE_ALIGNMENT - 1);
+  buffer.resize(buffer.size() + padded, 0);
+  if (bytes > 0) memcpy(buffer.data() + section.offset, records, bytes);
+}
+
+bool SaveWriter::WriteFile(const char *path) {
+  SaveHeader header = {};
+  header.magic = SAVE_MAGIC;
+  header.version = SAVE_VERSION;
+  header.headerSize = sizeof(SaveHeader);
+  header.endianMark = SAVE_ENDIAN_MARK;
+  header.sectionCount = (uint32_t)sections.size();
+  header.tableOffset = buffer.size();
+
+  const uint8_t *table = (const uint8_t *)sections.data();
+  buffer.insert(buffer.end(), table, table + sections.size() * sizeof(SaveSection));
+  header.fileSize = buffer.size();
+  header.checksum = SaveChecksum(buffer.data() + sizeof(SaveHeader), buffer.size() - sizeof(SaveHeader));
+  memcpy(buffer.data(), &header, sizeof(header));
+
+  FILE *file = fopen(path, "wb");
+  if (!file) return false;
+
+  bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+  ok = fclose(file) == 0 && ok;
+  return ok;
+}
+
+// --- Reading ---
+
+bool SaveReader::Open(const char *path) {
+  table = nullptr;
+  sectionCount = 0;
+
+  if (!file.Open(path)) {
+    error = "cannot open file";
+    return false;
+  }
+  if (!Validate()) {
+    file.Close();
+    return false;
+  }
+
+  error = nullptr;
+  return true;
+}
+
+bool SaveReader::Validate() {
+  const uint8_t *data = file.Data();
+  size_t size = file.Size();
+
+  // 1. Header
+  if (size < sizeof(SaveHeader)) { error = "truncated header"; return false; }
+  SaveHeader header;
+  memcpy(&header, data, sizeof(header));
+
+  if (header.magic != SAVE_MAGIC) { error = "not a save file"; return false; }
+  if (header.version != SAVE_VERSION) { error = "unsupported version"; return false; }
+  if (header.headerSize != sizeof(SaveHeader) || header.endianMark != SAVE_ENDIAN_MARK) {
+    error = "written on another platform";
+    return false;
+  }
+  if (header.fileSize != size) { error = "truncated file"; return false; }
+
+  // 2. Section table, then every section inside the file and aligned
+  if (header.tableOffset < sizeof(SaveHeader) || header.tableOffset > size ||
+      header.tableOffset % SAVE_ALIGNMENT != 0 ||
+      header.sectionCount > (size - header.tableOffset) / sizeof(SaveSection)) {
+    error = "bad section table";
+    return false;
+  }
+
+  const SaveSection *sections = (const SaveSection *)(data + header.tableOffset);
+  for (uint32_t i = 0; i < header.sectionCount; i++) {
+    const SaveSection& section = sections[i];
+    if (section.recordSize == 0 || section.offset < sizeof(SaveHeader) || section.offset > header.tableOffset ||
+        section.offset % SAVE_ALIGNMENT != 0 ||
+        section.count > (header.tableOffset - section.offset) / section.recordSize) {
+      error = "bad section";
+      return false;
+    }
+  }
+
+  // 3. Contents
+  if (SaveChecksum(data + sizeof(SaveHeader), size - sizeof(SaveHeader)) != header.checksum) {
+    error = "checksum mismatch";
+    return false;
+  }
+
+  table = sections;
+  sectionCount = header.sectionCount;
+  return true;
+}
+
+const void *SaveReader::Find(uint32_t id, size_t recordSize, size_t& count) const {
+  count = 0;
+  for (uint32_t i = 0; i < sectionCount; i++) {
+    if (table[i].id != id) continue;
+    if (table[i].recordSize != recordSize) return nullptr;
+
+    count = (size_t)table[i].count;
+    return file.Data() + table[i].offset;
+  }
+  return nullptr;
+}
+
+// --- Simulation ---
+
+static SavedBlock SaveBlock(const entity::Block& block) {
+  SavedBlock saved = {};
+  saved.index = block.index;
+  saved.position = block.position;
+  saved.size = block.size;
+  saved.color = block.color;
+  saved.colorOffset = block.color_offset;
+  return saved;
+}
+
+static entity::Block LoadBlock(const SavedBlock& saved) {
+  entity::Block block((size_t)saved.index, saved.position, saved.size, saved.color);
+  block.color_offset = saved.colorOffset;
+  return block;
+}
+
+void SaveSimulation(SaveWriter& writer, const Simulation& simulation) {
+  const entity::TowerStore& tower = simulation.placed_blocks;
+
+  // 1. Scalars, the current block and the tower's top
+  SavedSimulation core = {};
+  core.state = (uint32_t)simulation.state;
+  core.seed = simulation.seed;
+  core.tick = simulation.tick;
+  core.random = simulation.random.GetState();
+  core.towerSize = tower.Size();
+  if (!tower.Empty()) core.top = SaveBlock(tower.Top());
+  core.current = SaveBlock(simulation.current_block);
+  core.currentLastPosition = simulation.current_block_last_position;
+  core.baseSpeed = simulation.tuning.baseSpeed;
+  core.speedPerBlock = simulation.tuning.speedPerBlock;
+  core.perfectThreshold = simulation.tuning.perfectThreshold;
+  core.debrisGravity = simulation.debris.gravity;
+  core.debrisSleeping = simulation.debris.Sleeping();
+  writer.Add(SAVE_SIMULATION, core);
+
+  // 2. The settled tower goes in as stored, no repacking
+  writer.Add(SAVE_TOWER, tower.SettledData(), tower.Empty() ? 0 : tower.Size() - 1);
+
+  // 3. Components
+  std::vector<SavedMovement> movements(simulation.movements.Size());
+  size_t slot = 0;
+  for (const entity::Movement& movement : simulation.movements) {
+    SavedMovement& saved = movements[slot];
+    saved = {};
+    saved.owner = simulation.movements.Owner(slot);
+    saved.direction = (uint32_t)movement.direction;
+    saved.axis = (uint32_t)movement.axis;
+    saved.speed = movement.speed;
+    saved.threshold = movement.threshold;
+    saved.phase = movement.phase;
+    slot++;
+  }
+  writer.Add(SAVE_MOVEMENTS, movements.data(), movements.size());
+
+  const entity::DebrisPool& debris = simulation.debris;
+  std::vector<entity::DebrisPool::Piece> pieces(debris.Count());
+  for (size_t i = 0; i < debris.Count(); i++) pieces[i] = debris.Get(i);
+  writer.Add(SAVE_DEBRIS, pieces.data(), pieces.size());
+}
+
+bool LoadSimulation(const SaveReader& reader, Simulation& simulation) {
+  // 1. Check everything first
+  SavedSimulation core;
+  if (!reader.Get(SAVE_SIMULATION, core)) return false;
+  if (core.state > GAME_OVER_STATE || core.towerSize == 0) return false;
+
+  size_t settledCount, movementCount, pieceCount;
+  const entity::PackedBlock *settled = reader.Get<entity::PackedBlock>(SAVE_TOWER, settledCount);
+  const SavedMovement *movements = reader.Get<SavedMovement>(SAVE_MOVEMENTS, movementCount);
+  const entity::DebrisPool::Piece *pieces = reader.Get<entity::DebrisPool::Piece>(SAVE_DEBRIS, pieceCount);
+  if (!settled || !movements || !pieces) return false;
+  if (settledCount != core.towerSize - 1 || core.debrisSleeping > pieceCount) return false;
+  // The moving block (or the placeholder before the first press) always sits
+  // right above the tower
+  if (core.current.index != core.towerSize) return false;
+
+  bool currentMoves = false;
+  for (size_t i = 0; i < movementCount; i++) {
+    const SavedMovement& saved = movements[i];
+    if (saved.direction > entity::BACKWARD || saved.axis > entity::Z) return false;
+    // Ids are block indices, the moving block's is at most the tower size
+    if (saved.owner > core.towerSize) return false;
+    if (saved.owner == core.current.index) currentMoves = true;
+  }
+  // Placing a block reads the current block's movement
+  if (core.state == PLAYING_STATE && !currentMoves) return false;
+
+  // 2. Then restore
+  simulation.state = (GameState)core.state;
+  simulation.seed = core.seed;
+  simulation.tick = core.tick;
+  simulation.random.SetState(core.random);
+  simulation.tuning.baseSpeed = core.baseSpeed;
+  simulation.tuning.speedPerBlock = core.speedPerBlock;
+  simulation.tuning.perfectThreshold = core.perfectThreshold;
+
+  simulation.placed_blocks.Assign(settled, settledCount, LoadBlock(core.top));
+  simulation.current_block = LoadBlock(core.current);
+  simulation.current_block_last_position = core.currentLastPosition;
+
+  simulation.movements.Clear();
+  for (size_t i = 0; i < movementCount; i++) {
+    entity::Movement movement;
+    movement.speed = movements[i].speed;
+    movement.direction = (entity::Direction)movements[i].direction;
+    movement.axis = (entity::Axis)movements[i].axis;
+    movement.threshold = movements[i].threshold;
+    movement.phase = movements[i].phase;
+    simulation.movements.Add(movements[i].owner, movement);
+  }
+
+  // A save from a bigger pool (stress mode) gets a pool that fits it
+  if (simulation.debris.Capacity() < pieceCount) simulation.debris = entity::DebrisPool(pieceCount);
+  simulation.debris.gravity = core.debrisGravity;
+  simulation.debris.Assign(pieces, pieceCount, (size_t)core.debrisSleeping);
+
+  simulation.RebuildColliders();
+  return true;
+}
+
+}
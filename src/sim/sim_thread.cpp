@@ -0,0 +1,225 @@
+#include "sim/sim_thread.h"
+#include "raymath.h"
+#include "util/profiler.h"
+#include <chrono>
+
+namespace sim {
+
+double Clock() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration<double>(now).count();
+}
+
+SimulationThread::SimulationThread()
+  : seeds((uint64_t)std::chrono::steady_clock::now().time_since_epoch().count()) {}
+
+void SimulationThread::SetStress(const StressSettings& settings) {
+  if (running.load()) return;
+
+  stress = settings;
+  debrisStorm = DebrisStorm(settings.debrisPerSecond);
+  simulation.debris = entity::DebrisPool(settings.debrisCapacity);
+}
+
+void SimulationThread::Start(const char *replayPath) {
+  if (running.load()) return;
+
+  // Every finished run is appended, a few bytes per placement
+  if (!stress.enabled) replayWriter.Open(replayPath);
+  if (!resumed) Restart();
+  resumed = false;
+  Publish(Clock());
+
+  running.store(true);
+  thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+  if (!running.exchange(false)) return;
+
+  thread.join();
+  replayWriter.Close();
+}
+
+void SimulationThread::Save(SaveWriter& writer) const {
+  if (running.load()) return;
+
+  SaveSimulation(writer, simulation);
+
+  SavedSession session = { cameraY, previousCameraY, cameraTargetY, previousCameraTargetY };
+  writer.Add(SAVE_SESSION, session);
+
+  // The press log goes along, a resumed run still ends up as a full replay
+  const ReplayRun& run = replayRecorder.Current();
+  std::vector<SavedPress> presses(run.pressTicks.size());
+  for (size_t i = 0; i < presses.size(); i++) {
+    presses[i] = {};
+    presses[i].tick = run.pressTicks[i];
+    presses[i].subTick = run.pressSubTicks[i];
+  }
+  writer.Add(SAVE_REPLAY, presses.data(), presses.size());
+}
+
+bool SimulationThread::Load(const SaveReader& reader) {
+  if (running.load() || stress.enabled) return false;
+
+  SavedSession session;
+  size_t pressCount;
+  const SavedPress *presses = reader.Get<SavedPress>(SAVE_REPLAY, pressCount);
+  if (!reader.Get(SAVE_SESSION, session) || !presses) return false;
+  if (!LoadSimulation(reader, simulation)) return false;
+
+  cameraY = session.cameraY;
+  previousCameraY = session.previousCameraY;
+  cameraTargetY = session.cameraTargetY;
+  previousCameraTargetY = session.previousCameraTargetY;
+
+  replayRecorder.Begin(simulation.seed, (uint32_t)(1.0f / SIMULATION_STEP + 0.5f));
+  for (size_t i = 0; i < pressCount; i++) replayRecorder.RecordPress(presses[i].tick, (uint8_t)presses[i].subTick);
+
+  // The render side mirrors the loaded tower from here, like a prebuilt one
+  towerCopy = std::make_shared<const entity::TowerStore>(simulation.placed_blocks);
+  pendingPresses = 0;
+  generation++;
+  resumed = true;
+  return true;
+}
+
+void SimulationThread::Restart() {
+  // Every run gets a fresh seed, the simulation owns all randomness after this
+  simulation.Reset(seeds.Next() & 0x7FFFFFFF);
+
+  // Blocks placed here skip the per-step snapshots, the renderer copies them
+  // from the shared store instead
+  if (stress.enabled && stress.towerHeight > 0) {
+    BuildTower(simulation, stress.towerHeight);
+    towerCopy = std::make_shared<const entity::TowerStore>(simulation.placed_blocks);
+
+    // Start the camera up there rather than climbing for seconds
+    float top = 2.0f * simulation.placed_blocks.Size();
+    cameraY = previousCameraY = 50 + top;
+    cameraTargetY = previousCameraTargetY = top;
+  } else {
+    // A loaded or stress tower from the last run must not be mirrored into this one
+    towerCopy.reset();
+  }
+
+  replayRecorder.Begin(simulation.seed, (uint32_t)(1.0f / SIMULATION_STEP + 0.5f));
+  pendingPresses = 0;
+  generation++;
+}
+
+void SimulationThread::Run() {
+  const float step = SIMULATION_STEP;
+  double stepEnd = Clock();
+
+  while (running.load(std::memory_order_relaxed)) {
+    // 1. Queue everything the render thread saw since the last pass
+    double press;
+    while (input.Pop(press)) {
+      if (pendingPresses < MAX_PENDING_PRESSES) pressTimes[pendingPresses++] = press;
+    }
+
+    // 2. Catch up to the clock, dropping the backlog after a long stall
+    double now = Clock();
+    int steps = 0;
+    while (stepEnd + step <= now && steps < MAX_CATCHUP_STEPS) {
+      stepEnd += step;
+      Step(step, stepEnd);
+      steps++;
+    }
+    if (steps == MAX_CATCHUP_STEPS && stepEnd + step <= now) stepEnd = now;
+    if (steps > 0) Publish(stepEnd);
+
+    // 3. Sleep until the next step is due
+    double wait = stepEnd + step - Clock();
+    if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+  }
+}
+
+Input SimulationThread::TakeInput(float dt, double stepEnd) {
+  Input input;
+  if (pendingPresses == 0 || pressTimes[0] > stepEnd) return input;
+
+  // Presses older than this step (a stall, or two in one step) count from its start
+  input.press = true;
+  input.subTick = Input::SubTickFor(pressTimes[0] - (stepEnd - dt), dt);
+
+  pendingPresses--;
+  for (int i = 0; i < pendingPresses; i++) pressTimes[i] = pressTimes[i + 1];
+  return input;
+}
+
+void SimulationThread::Step(float dt, double stepEnd) {
+  PROFILE_SCOPE(util::PHASE_UPDATE);
+
+  Input input = TakeInput(dt, stepEnd);
+  if (input.press && simulation.state != GAME_OVER_STATE) {
+    replayRecorder.RecordPress(simulation.tick, input.subTick);
+  }
+
+  StepEvents events;
+  {
+    PROFILE_SCOPE(util::PHASE_SIM_STEP);
+    events = simulation.Step(input, dt);
+    if (stress.enabled) debrisStorm.Update(simulation, dt);
+  }
+
+  if (events.perfect) perfectCount++;
+  if (events.gameOver) replayWriter.Write(replayRecorder.Finish(simulation));
+  if (events.restartRequested) Restart();
+
+  PROFILE_SCOPE(util::PHASE_CAMERA);
+  size_t placed = simulation.placed_blocks.Size();
+  previousCameraY = cameraY;
+  previousCameraTargetY = cameraTargetY;
+  cameraY = Lerp(cameraY, 50 + (2 * placed), dt);
+  cameraTargetY = Lerp(cameraTargetY, 2 * placed, dt);
+}
+
+void SimulationThread::Publish(double stepTime) {
+  FrameSnapshot& snapshot = snapshots.Back();
+
+  snapshot.tick = simulation.tick;
+  snapshot.stepTime = stepTime;
+  snapshot.generation = generation;
+  snapshot.state = simulation.state;
+  snapshot.score = simulation.Score();
+  snapshot.perfectCount = perfectCount;
+  // Only after a long render stall, the copy is the whole tower
+  if (towerCopyRequested.exchange(false)) {
+    towerCopy = std::make_shared<const entity::TowerStore>(simulation.placed_blocks);
+  }
+  if (snapshot.towerCopy != towerCopy) snapshot.towerCopy = towerCopy;
+
+  const entity::TowerStore& placed = simulation.placed_blocks;
+  snapshot.placedCount = placed.Size();
+  snapshot.recentCount = placed.Size() < SNAPSHOT_RECENT_BLOCKS ? placed.Size() : SNAPSHOT_RECENT_BLOCKS;
+  size_t first = placed.Size() - snapshot.recentCount;
+  for (size_t i = 0; i < snapshot.recentCount; i++) snapshot.recent[i] = placed.Get(first + i);
+
+  snapshot.current = simulation.current_block;
+  snapshot.currentLastPosition = simulation.current_block_last_position;
+
+  const entity::DebrisPool& debris = simulation.debris;
+  if (snapshot.debris.capacity() < debris.Capacity()) snapshot.debris.reserve(debris.Capacity());
+  snapshot.debris.resize(debris.Count());
+  for (size_t i = 0; i < debris.Count(); i++) {
+    DebrisInstance& piece = snapshot.debris[i];
+    piece.position = debris.Position(i);
+    piece.lastPosition = debris.Position(i, 0.0f);
+    piece.rotation = debris.Rotation(i);
+    piece.lastRotation = debris.Rotation(i, 0.0f);
+    piece.size = debris.Size(i);
+    piece.color = debris.Color(i);
+  }
+
+  snapshot.cameraY = cameraY;
+  snapshot.previousCameraY = previousCameraY;
+  snapshot.cameraTargetY = cameraTargetY;
+  snapshot.previousCameraTargetY = previousCameraTargetY;
+
+  snapshots.Publish();
+}
+
+}
@@ -0,0 +1,215 @@
+#include "sim/simulation.h"
+#include <cmath>
+
+namespace sim {
+
+Simulation::Simulation(uint64_t seed)
+{
+  Reset(seed);
+}
+
+void Simulation::Reset(uint64_t seed) {
+  this->seed = seed;
+  this->tick = 0;
+  this->random.Seed(seed);
+  this->state = READY_STATE;
+  this->placed_blocks.Clear();
+  this->movements.Clear();
+  this->debris.Clear();
+
+  // 1. Create and move the BASE block into the tower first
+  entity::Block baseBlock(0, {0,0,0}, {10, 2, 10}, {255, 255, 255, 255});
+  baseBlock.color_offset = this->random.Range(0, 100);
+  this->placed_blocks.Push(baseBlock);
+  RebuildColliders();
+
+  // 2. Placeholder until the first press, it is not drawn outside PLAYING_STATE
+  this->current_block = entity::Block(1, {0, 2, 0}, {10, 2, 10}, {200, 200, 200, 255});
+  this->current_block_last_position = this->current_block.position;
+}
+
+void Simulation::RebuildColliders() {
+  // The tower is read straight from placed_blocks, only the terrain goes in
+  this->colliders.Clear();
+  this->colliders.Insert(TERRAIN_POSITION, TERRAIN_SIZE);
+}
+
+StepEvents Simulation::Step(const Input& input, float dt) {
+  StepEvents events;
+
+  UpdateGameState(input, dt, events);
+
+  // A freshly spawned block has no previous step to blend from
+  this->current_block_last_position = this->current_block.position;
+
+  UpdateFallingBlocks(dt);
+  UpdateCurrentBlock(dt);
+
+  this->tick++;
+  return events;
+}
+
+void Simulation::UpdateGameState(const Input& input, float dt, StepEvents& events) {
+    switch (this->state) {
+        case READY_STATE:
+            if (input.press) {
+                this->state = PLAYING_STATE;
+                this->current_block = CreateMovingBlock();
+                events.started = true;
+            }
+            break;
+
+        case PLAYING_STATE:
+            if (input.press) {
+                PlaceBlock(events, dt * input.subTick / SUB_TICKS);
+            }
+            break;
+
+        case GAME_OVER_STATE:
+            // Restarting is up to the caller, it picks the next seed
+            if (input.press) events.restartRequested = true;
+            break;
+    }
+}
+
+void Simulation::UpdateCurrentBlock(float dt) {
+    if (this->state != PLAYING_STATE) return;
+
+    entity::Movement *movement = GetCurrentMovement();
+    if (movement) {
+        movement->Update(current_block.position, dt);
+    }
+}
+
+void Simulation::UpdateFallingBlocks(float dt) {
+  // Integrates the awake pieces, lands them on the terrain and the tower and
+  // drops the ones that fell past both
+  debris.Update(dt, colliders, placed_blocks);
+}
+
+entity::Block Simulation::CreateMovingBlock() {
+    const entity::Block& target = GetPreviousBlock();
+
+    // 1. Determine Axis (Flip from X to Z or vice versa)
+    entity::Axis axis = (target.index % 2 == 0) ? entity::Z : entity::X;
+    entity::Direction direction = (random.Range(0, 1) == 0) ? entity::FORWARD : entity::BACKWARD;
+
+    // 2. Calculate Position
+    Vector3 position = target.position;
+    position.y += target.size.y;
+
+    if (axis == entity::X) {
+        position.x = (direction == entity::FORWARD ? -1 : 1) * MOVEMENT_THRESHOLD;
+    } else {
+        position.z = (direction == entity::FORWARD ? -1 : 1) * MOVEMENT_THRESHOLD;
+    }
+
+    // 3. Generate Color
+    size_t index = target.index + 1;
+    int offset = target.color_offset + (int)index;
+    math::Color newColor = {
+        (unsigned char)(sinf(0.3f * offset) * 55 + 200),
+        (unsigned char)(sinf(0.3f * offset + 2.0f) * 55 + 200),
+        (unsigned char)(sinf(0.3f * offset + 4.0f) * 55 + 200),
+        255
+    };
+
+    // 4. Construct the Block
+    entity::Block newBlock(index, position, target.size, newColor);
+    newBlock.color_offset = target.color_offset;
+
+    // 5. Only the moving block gets a Movement component
+    float speed = tuning.baseSpeed + (index * tuning.speedPerBlock);
+    entity::Movement& movement = movements.Add(newBlock.Id(), {.speed = speed, .direction = direction, .axis = axis});
+    movement.Start(axis == entity::X ? position.x : position.z);
+
+    return newBlock;
+}
+
+void Simulation::CreateFallingBlock(Vector3 position, Vector3 size, math::Color color) {
+    // 1. Randomize the "tumble" velocity
+    Vector3 initialVel = {
+        (float)random.Range(-300, 300) / 100.0f,
+        (float)random.Range(-100, 100) / 100.0f, // Slight vertical pop
+        (float)random.Range(-300, 300) / 100.0f
+    };
+
+    // 2. Hand it to the pool, which stores it without any allocation
+    debris.Spawn(position, size, initialVel, { 2.0f, 1.0f, 0.5f }, color);
+}
+
+void Simulation::PlaceBlock(StepEvents& events, float pressOffset) {
+  entity::Block& current = this->current_block;
+  const entity::Block& target = GetPreviousBlock();
+  const entity::Movement *movement = GetCurrentMovement();
+
+  bool isXAxis = movement->axis == entity::X;
+
+  // 1. Where the block was at the moment of the press
+  if (isXAxis) current.position.x = movement->PositionAt(pressOffset);
+  else         current.position.z = movement->PositionAt(pressOffset);
+
+  float currentPos = isXAxis ? current.position.x : current.position.z;
+  float targetPos  = isXAxis ? target.position.x  : target.position.z;
+  float currentSize = isXAxis ? current.size.x    : current.size.z;
+  float targetSize  = isXAxis ? target.size.x     : target.size.z;
+
+  float delta = currentPos - targetPos;
+  float overlay = targetSize - fabs(delta);
+
+  // Game Over Check
+  if (overlay < MIN_OVERLAY) {
+    this->state = GAME_OVER_STATE;
+    events.gameOver = true;
+    return;
+  }
+
+  bool isPerfect = fabs(delta) < tuning.perfectThreshold;
+
+  if (isPerfect) {
+    // Snap to target for that "Perfect" feel
+    if (isXAxis) current.position.x = target.position.x;
+    else         current.position.z = target.position.z;
+
+    events.perfect = true;
+  } else {
+    // --- THE SLICE (The part that stays) ---
+    float newSize = overlay;
+    float newPos = targetPos + (delta / 2.0f);
+
+    // --- THE CHOP (The debris) ---
+    float choppedSize = currentSize - overlay;
+    float choppedPos = (delta > 0)
+        ? (newPos + newSize / 2.0f + choppedSize / 2.0f)
+        : (newPos - newSize / 2.0f - choppedSize / 2.0f);
+
+    // Update Current Block Size/Pos
+    if (isXAxis) {
+      current.size.x = newSize;
+      current.position.x = newPos;
+    } else {
+      current.size.z = newSize;
+      current.position.z = newPos;
+    }
+
+    // Create the debris block
+    Vector3 dPos = current.position;
+    Vector3 dSize = current.size;
+    if (isXAxis) { dPos.x = choppedPos; dSize.x = choppedSize; }
+    else         { dPos.z = choppedPos; dSize.z = choppedSize; }
+
+    CreateFallingBlock(dPos, dSize, current.color);
+  }
+
+  // 2. Settled blocks stop moving for good
+  this->movements.Remove(current.Id());
+
+  // 3. Copy it into the tower, it becomes the block the next one is cut against
+  this->placed_blocks.Push(current);
+  events.placed = true;
+
+  // 4. Spawn the next moving block
+  this->current_block = CreateMovingBlock();
+}
+
+}
@@ -0,0 +1,57 @@
+#include "sim/stress.h"
+#include "sim/fixed_timestep.h"
+
+namespace sim {
+
+void PlacePerfect(Simulation& simulation) {
+  const entity::Block& target = simulation.GetPreviousBlock();
+  entity::Movement *movement = simulation.GetCurrentMovement();
+  movement->Start(movement->axis == entity::X ? target.position.x : target.position.z);
+
+  StepEvents events;
+  simulation.PlaceBlock(events);
+}
+
+void BuildTower(Simulation& simulation, size_t height) {
+  if (simulation.state == READY_STATE) {
+    Input press;
+    press.press = true;
+    simulation.Step(press, SIMULATION_STEP);
+  }
+
+  simulation.placed_blocks.Reserve(height);
+  while (simulation.state == PLAYING_STATE && simulation.placed_blocks.Size() < height) {
+    PlacePerfect(simulation);
+  }
+}
+
+void DebrisStorm::Update(Simulation& simulation, float dt) {
+  credit += perSecond * dt;
+
+  const entity::Block& top = simulation.GetPreviousBlock();
+  Random& random = simulation.random;
+
+  while (credit >= 1.0f) {
+    credit -= 1.0f;
+
+    // 1. A slice hanging over one of the four edges of the top block
+    float slice = 0.2f + random.Float() * 2.8f;
+    float side = random.Range(0, 1) ? 1.0f : -1.0f;
+    Vector3 position = top.position;
+    Vector3 size = top.size;
+    position.y += top.size.y;
+
+    // 2. Cut across X or Z, the way the moving block alternates
+    if (random.Range(0, 1)) {
+      position.x += side * (top.size.x + slice) / 2.0f;
+      size.x = slice;
+    } else {
+      position.z += side * (top.size.z + slice) / 2.0f;
+      size.z = slice;
+    }
+
+    simulation.CreateFallingBlock(position, size, top.color);
+  }
+}
+
+}
@@ -0,0 +1,32 @@
+#include "ui/message_pool.h"
+#include <cstring>
+
+namespace ui
+{
+
+TextElement& MessagePool::Spawn(const char *text) {
+    if (count == MAX_UI_MESSAGES) {
+        head = (head + 1) % MAX_UI_MESSAGES;
+        count--;
+    }
+
+    TextElement& element = slots[(head + count) % MAX_UI_MESSAGES];
+    count++;
+
+    strncpy(element.text, text, MAX_MESSAGE_LENGTH - 1);
+    element.text[MAX_MESSAGE_LENGTH - 1] = '\0';
+    return element;
+}
+
+void MessagePool::Update(float dt) {
+    for (size_t i = 0; i < count; i++) {
+        slots[(head + i) % MAX_UI_MESSAGES].lifetime -= dt;
+    }
+
+    while (count > 0 && slots[head].lifetime <= 0) {
+        head = (head + 1) % MAX_UI_MESSAGES;
+        count--;
+    }
+}
+
+}
@@ -0,0 +1,97 @@
+#include "ui/profiler_overlay.h"
+#include "util/frame_arena.h"
+#include <algorithm>
+
+namespace ui {
+
+static const float PERCENTILES[3] = { 0.50f, 0.95f, 0.99f };
+static const Color PERCENTILE_COLORS[3] = { GREEN, YELLOW, RED };
+static const char *PERCENTILE_LABELS[3] = { "p50", "p95", "p99" };
+
+void ProfilerOverlay::HandleInput() {
+    if (IsKeyPressed(KEY_F3)) visible = !visible;
+}
+
+/// @brief Percentile of the first count values in scratch (reorders them)
+float ProfilerOverlay::Percentile(size_t count, float p) {
+    if (count == 0) return 0.0f;
+    size_t k = (size_t)(p * (float)(count - 1) + 0.5f);
+    std::nth_element(scratch, scratch + k, scratch + count);
+    return scratch[k];
+}
+
+void ProfilerOverlay::Draw(int x, int y, const render::RenderStats& stats) {
+    if (!visible) return;
+
+    size_t count = util::Profiler::Instance().Snapshot(records, util::PROFILER_HISTORY);
+    if (count == 0) return;
+    util::FrameArena& arena = util::FrameArena::Instance();
+
+    const int width = 360;
+    const int graphHeight = 90;
+    const int rowHeight = 14;
+    int height = graphHeight + 40 + rowHeight * (util::PHASE_COUNT + 3);
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+
+    // 1. Rolling percentiles of the whole frame time, one column per frame
+    size_t columns = std::min(count, PROFILER_GRAPH_FRAMES);
+    float maxMs = 1000.0f / 30.0f;
+    for (size_t c = 0; c < columns; c++) {
+        size_t last = count - columns + c;
+        size_t first = last + 1 >= PROFILER_PERCENTILE_WINDOW ? last + 1 - PROFILER_PERCENTILE_WINDOW : 0;
+        size_t window = last + 1 - first;
+
+        for (size_t i = 0; i < window; i++) scratch[i] = records[first + i].ms[util::PHASE_FRAME];
+        for (int p = 0; p < 3; p++) {
+            graph[p][c] = Percentile(window, PERCENTILES[p]);
+        }
+        maxMs = std::max(maxMs, graph[2][c]);
+    }
+
+    int graphTop = y + 20;
+    float scaleY = graphHeight / maxMs;
+    float stepX = (float)(width - 10) / PROFILER_GRAPH_FRAMES;
+
+    // 16.6 ms budget line
+    int budgetY = graphTop + graphHeight - (int)(1000.0f / 60.0f * scaleY);
+    DrawLine(x + 5, budgetY, x + width - 5, budgetY, Fade(WHITE, 0.3f));
+
+    for (int p = 0; p < 3; p++) {
+        for (size_t c = 1; c < columns; c++) {
+            Vector2 from = { x + 5 + (c - 1) * stepX, graphTop + graphHeight - graph[p][c - 1] * scaleY };
+            Vector2 to = { x + 5 + c * stepX, graphTop + graphHeight - graph[p][c] * scaleY };
+            DrawLineV(from, to, PERCENTILE_COLORS[p]);
+        }
+        DrawText(arena.Format("%s %.2f ms", PERCENTILE_LABELS[p], graph[p][columns - 1]), x + 5 + p * 115, y + 4, 10, PERCENTILE_COLORS[p]);
+    }
+
+    // 2. Per-phase percentiles over the whole history
+    int rowY = graphTop + graphHeight + 10;
+    DrawText(arena.Format("phase (%d frames)", (int)count), x + 5, rowY, 10, LIGHTGRAY);
+    for (int p = 0; p < 3; p++) DrawText(PERCENTILE_LABELS[p], x + 170 + p * 60, rowY, 10, PERCENTILE_COLORS[p]);
+
+    for (int phase = 0; phase < util::PHASE_COUNT; phase++) {
+        rowY += rowHeight;
+        for (size_t i = 0; i < count; i++) scratch[i] = records[i].ms[phase];
+
+        DrawText(util::PhaseName((util::ProfilePhase)phase), x + 5, rowY, 10, WHITE);
+        for (int p = 0; p < 3; p++) {
+            DrawText(arena.Format("%6.3f", Percentile(count, PERCENTILES[p])), x + 170 + p * 60, rowY, 10, WHITE);
+        }
+    }
+
+    // 3. Frame arena, overflows mean a frame spilled to the heap
+    rowY += rowHeight;
+    DrawText(arena.Format("frame arena %zu / %zu KB, peak %zu KB, %zu overflows", arena.Used() / 1024,
+                          arena.Capacity() / 1024, arena.Peak() / 1024, arena.Overflows()),
+             x + 5, rowY, 10, arena.Overflows() > 0 ? YELLOW : LIGHTGRAY);
+
+    // 4. Last submit: state changes are shader + texture + vertex array binds
+    rowY += rowHeight;
+    DrawText(arena.Format("draws %zu (%zu commands, %zu custom), state changes %zu (%zu/%zu/%zu)",
+                          stats.drawCalls, stats.commands, stats.customs, stats.StateChanges(),
+                          stats.shaderChanges, stats.textureChanges, stats.meshChanges),
+             x + 5, rowY, 10, LIGHTGRAY);
+}
+
+}
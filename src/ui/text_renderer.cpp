@@ -0,0 +1,156 @@
+#include "ui/text_renderer.h"
+#include "rlgl.h"
+
+namespace ui
+{
+
+// Same defaults DrawText uses with the built-in font
+static const int DEFAULT_FONT_SIZE = 10;
+// Layouts kept before the oldest are evicted, HUD strings are few and repetitive
+static const size_t MAX_CACHED_LAYOUTS = 256;
+// Quads submitted per rlBegin/rlEnd, well under the default render batch
+static const size_t QUADS_PER_SUBMIT = 1024;
+
+static uint64_t LayoutKey(const char *text, int fontSize, float fixedAdvance) {
+    // FNV-1a over the text, then mix in the size and spacing mode
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char *c = text; *c; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 0x100000001B3ull;
+    }
+    hash ^= (uint64_t)fontSize * 0x9E3779B97F4A7C15ull;
+    hash ^= (uint64_t)(fixedAdvance * 64.0f) << 40;
+    return hash;
+}
+
+void TextRenderer::Load() {
+    font = GetFontDefault();
+    batch.reserve(QUADS_PER_SUBMIT);
+}
+
+void TextRenderer::BuildLayout(TextLayout& layout, const char *text, int fontSize, float fixedAdvance) const {
+    if (fontSize < DEFAULT_FONT_SIZE) fontSize = DEFAULT_FONT_SIZE;
+
+    float scale = (float)fontSize / font.baseSize;
+    float spacing = (float)fontSize / DEFAULT_FONT_SIZE;
+    float padding = (float)font.glyphPadding;
+
+    layout.glyphs.clear();
+    layout.fontSize = fontSize;
+    layout.width = 0.0f;
+
+    // Mirrors DrawTextEx/DrawTextCodepoint for the single byte HUD strings
+    float penX = 0.0f;
+    for (int i = 0; text[i] != '\0'; i++) {
+        int index = GetGlyphIndex(font, (unsigned char)text[i]);
+        const Rectangle& rec = font.recs[index];
+        const GlyphInfo& glyph = font.glyphs[index];
+        float x = fixedAdvance > 0.0f ? i * fixedAdvance : penX;
+
+        if (text[i] != ' ') {
+            GlyphQuad quad;
+            quad.source = { rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding };
+            quad.dest = {
+                x + glyph.offsetX * scale - padding * scale,
+                glyph.offsetY * scale - padding * scale,
+                quad.source.width * scale,
+                quad.source.height * scale
+            };
+            quad.charIndex = i;
+            layout.glyphs.push_back(quad);
+        }
+
+        float advance = (glyph.advanceX == 0 ? rec.width : (float)glyph.advanceX) * scale;
+        penX += advance + spacing;
+        layout.width = x + advance;
+    }
+}
+
+const TextLayout& TextRenderer::Layout(const char *text, int fontSize, float fixedAdvance) {
+    uint64_t key = LayoutKey(text, fontSize, fixedAdvance);
+
+    // 1. The hash only narrows it down, the string has to match too
+    auto range = cacheIndex.equal_range(key);
+    for (auto found = range.first; found != range.second; ++found) {
+        CachedLayout& cached = *found->second;
+        if (cached.fontSize != fontSize || cached.fixedAdvance != fixedAdvance || cached.text != text) continue;
+
+        cache.splice(cache.begin(), cache, found->second);
+        return cached.layout;
+    }
+
+    // 2. Evict the least recently used layout
+    if (cache.size() >= MAX_CACHED_LAYOUTS) {
+        const CachedLayout& oldest = cache.back();
+        auto stale = cacheIndex.equal_range(oldest.hash);
+        for (auto it = stale.first; it != stale.second; ++it) {
+            if (&*it->second != &oldest) continue;
+            cacheIndex.erase(it);
+            break;
+        }
+        cache.pop_back();
+    }
+
+    // 3. Build the new one at the front
+    cache.push_front(CachedLayout{ text, fontSize, fixedAdvance, key, TextLayout() });
+    cacheIndex.emplace(key, cache.begin());
+    BuildLayout(cache.front().layout, text, fontSize, fixedAdvance);
+    return cache.front().layout;
+}
+
+void TextRenderer::Begin() {
+    util::Renew(batch, lastBatchSize);
+}
+
+void TextRenderer::Draw(const TextLayout& layout, Vector2 position, Color color, const float *glyphOffsetsY) {
+    for (size_t i = 0; i < layout.glyphs.size(); i++) {
+        const GlyphQuad& glyph = layout.glyphs[i];
+        float offsetY = glyphOffsetsY ? glyphOffsetsY[i] : 0.0f;
+
+        QueuedQuad quad;
+        quad.source = glyph.source;
+        quad.dest = { position.x + glyph.dest.x, position.y + glyph.dest.y + offsetY, glyph.dest.width, glyph.dest.height };
+        quad.color = color;
+        batch.push_back(quad);
+    }
+}
+
+void TextRenderer::Flush() {
+    lastBatchSize = batch.size();
+    if (batch.empty()) return;
+
+    float width = (float)font.texture.width;
+    float height = (float)font.texture.height;
+
+    for (size_t first = 0; first < batch.size(); first += QUADS_PER_SUBMIT) {
+        size_t last = first + QUADS_PER_SUBMIT < batch.size() ? first + QUADS_PER_SUBMIT : batch.size();
+        rlCheckRenderBatchLimit(4 * (int)(last - first));
+
+        rlSetTexture(font.texture.id);
+        rlBegin(RL_QUADS);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+
+            for (size_t i = first; i < last; i++) {
+                const QueuedQuad& quad = batch[i];
+                const Rectangle& src = quad.source;
+                const Rectangle& dst = quad.dest;
+
+                rlColor4ub(quad.color.r, quad.color.g, quad.color.b, quad.color.a);
+
+                rlTexCoord2f(src.x / width, src.y / height);
+                rlVertex2f(dst.x, dst.y);
+                rlTexCoord2f(src.x / width, (src.y + src.height) / height);
+                rlVertex2f(dst.x, dst.y + dst.height);
+                rlTexCoord2f((src.x + src.width) / width, (src.y + src.height) / height);
+                rlVertex2f(dst.x + dst.width, dst.y + dst.height);
+                rlTexCoord2f((src.x + src.width) / width, src.y / height);
+                rlVertex2f(dst.x + dst.width, dst.y);
+            }
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+    batch.clear();
+}
+
+}
@@ -1,25 +1,73 @@
 #include "ui/ui_manager.h"
 #include "raymath.h"
+#include "util/frame_arena.h"
+#include "util/profiler.h"
 #include <cmath>
+#include <cstring>
 
 namespace ui
 {
 
+// Longest message the WIGGLE offsets are computed for
+static const int MAX_MESSAGE_GLYPHS = 64;
+// Below this the upscaled HUD text gets too soft
+static const float MIN_POST_SCALE = 0.75f;
+
 UIManager::UIManager() {
-  canvas = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
-  uiShader = LoadShader(0, "shaders/ui_post.glsl");
-  intensityLoc = GetShaderLocation(uiShader, "effectIntensity");
-  timeLoc = GetShaderLocation(uiShader, "time");
+  canvasHandle = render::ResourceCache::Instance().AcquireRenderTexture("ui_canvas", GetScreenWidth(), GetScreenHeight());
+  canvas = canvasHandle.Get();
+  postMaterial.Load();
+  compositeMaterial.Load();
+  text.Load();
 }
 
 UIManager::~UIManager() {
-  UnloadRenderTexture(canvas);
-  UnloadShader(uiShader);
+  canvasHandle.Reset();
+  postMaterial.Unload();
+  compositeMaterial.Unload();
+}
+
+void UIManager::SetState(UIState newState) {
+  if (newState != currentState) canvasDirty = true;
+  currentState = newState;
+}
+
+void UIManager::SetScore(size_t newScore) {
+  if (newScore != score) canvasDirty = true;
+  score = newScore;
+}
+
+void UIManager::Save(sim::SaveWriter& writer) const {
+  // Zeroed so the padding does not put garbage in the file
+  SavedUI saved;
+  memset(&saved, 0, sizeof(saved));
+  saved.effectTimer = effectTimer;
+  messages.ForEach([&](const TextElement& element) {
+    memcpy(&saved.messages[saved.messageCount++], &element, sizeof(element));
+  });
+  writer.Add(sim::SAVE_UI, saved);
+}
+
+bool UIManager::Load(const sim::SaveReader& reader) {
+  SavedUI saved;
+  if (!reader.Get(sim::SAVE_UI, saved) || saved.messageCount > MAX_UI_MESSAGES) return false;
+
+  effectTimer = saved.effectTimer;
+  messages.Clear();
+  for (uint32_t i = 0; i < saved.messageCount; i++) {
+    TextElement& element = messages.Spawn("");
+    element = saved.messages[i];
+    element.text[MAX_MESSAGE_LENGTH - 1] = '\0';
+    if (element.anim > UIAnimType::FLOAT_UP) element.anim = UIAnimType::NONE;
+  }
+  canvasDirty = true;
+  return true;
 }
+
 void UIManager::SpawnPerfect() {
     TriggerPulse(); // Triggers the shader intensity
-    TextElement e;
-    e.text = "PERFECT!";
+    TextElement& e = messages.Spawn("PERFECT!");
+    canvasDirty = true;
     // Move it to the right side of the tower
     e.position = { (float)GetScreenWidth() * 0.65f, 300.0f }; 
     e.fontSize = 35.0f; // Smaller
@@ -27,8 +75,8 @@ void UIManager::SpawnPerfect() {
     e.lifetime = 1.5f;
     e.maxLifetime = 1.5f;
     e.anim = UIAnimType::WIGGLE; // Our sequential logic
+    e.delay = 0.0f;
     e.useBloom = true;
-    elements.push_back(e);
 }
 
 void UIManager::SpawnClose() {
@@ -36,29 +84,39 @@ void UIManager::SpawnClose() {
   SpawnMessage("Close...", { (float)GetScreenWidth() * 0.7f, 350.0f }, LIGHTGRAY, false, UIAnimType::NONE);
 }
 
-void UIManager::SpawnMessage(std::string text, Vector2 pos, Color color, bool isBloom, UIAnimType anim) {
-  elements.push_back({text, pos, 40.0f, color, 1.5f, 1.5f, anim, 0.0f, isBloom});
+void UIManager::SpawnMessage(const char *text, Vector2 pos, Color color, bool isBloom, UIAnimType anim) {
+  TextElement& e = messages.Spawn(text);
+  canvasDirty = true;
+  e.position = pos;
+  e.fontSize = 40.0f;
+  e.color = color;
+  e.lifetime = 1.5f;
+  e.maxLifetime = 1.5f;
+  e.anim = anim;
+  e.delay = 0.0f;
+  e.useBloom = isBloom;
 }
 
 void UIManager::Update(float dt) {
   effectTimer = fmaxf(0.0f, effectTimer - dt * 2.0f);
-  
-  for (int i = elements.size() - 1; i >= 0; i--) {
-    elements[i].lifetime -= dt;
-    if (elements[i].lifetime <= 0) elements.erase(elements.begin() + i);
-  }
+
+  // Live messages move, and the frame after the last one expires erases it
+  if (messages.Count() > 0) canvasDirty = true;
+  messages.Update(dt);
 }
 
-void UIManager::DrawScore(size_t score)
+void UIManager::DrawScore()
 {
-  const char* title = TextFormat("%zu", score);
   int fontSize = 120;
 
-  int screenWidth = GetScreenWidth();
-  int textSize = MeasureText(title, fontSize);
+  if (score != scoreLayoutValue) {
+    text.BuildLayout(scoreLayout, util::FrameArena::Instance().Format("%zu", score), fontSize);
+    scoreLayoutValue = score;
+  }
 
-  int position = (screenWidth - textSize) / 2;
-  DrawText(title, position, 200, fontSize, RAYWHITE);
+  int screenWidth = GetScreenWidth();
+  int position = (screenWidth - (int)scoreLayout.width) / 2;
+  text.Draw(scoreLayout, { (float)position, 200 }, RAYWHITE);
 }
 
 
@@ -74,16 +132,19 @@ void UIManager::DrawActiveOverlay()
   }
 }
 
-void DrawOverlay(const char *title, const char *subtitle, size_t titleSize, size_t subtitleSize, int titleY, int subtitleY) {
+void UIManager::DrawOverlay(const char *title, const char *subtitle, int titleSize, int subtitleSize, int titleY, int subtitleY) {
   Color dark = WHITE;
   Color light = LIGHTGRAY;
 
+  const TextLayout& titleLayout = text.Layout(title, titleSize);
+  const TextLayout& subtitleLayout = text.Layout(subtitle, subtitleSize);
+
   int screenWidth = GetScreenWidth();
-  int titleWidth = MeasureText(title, titleSize);
-  int subtitleWidth = MeasureText(subtitle, subtitleSize);
+  int titleX = (screenWidth - (int)titleLayout.width) / 2;
+  int subtitleX = (screenWidth - (int)subtitleLayout.width) / 2;
 
-  DrawText(title, (screenWidth - titleWidth) / 2, titleY, titleSize, dark);
-  DrawText(subtitle, (screenWidth - subtitleWidth) / 2, subtitleY, subtitleSize, light);
+  text.Draw(titleLayout, { (float)titleX, (float)titleY }, dark);
+  text.Draw(subtitleLayout, { (float)subtitleX, (float)subtitleY }, light);
 }
 
 void UIManager::DrawStartOverlay() {
@@ -94,39 +155,103 @@ void UIManager::DrawGameOverOverlay() {
   DrawOverlay("GAME OVER", "Click or Press Space", 60, 30, 100, 170);
 }
 
-void UIManager::BeginUI() { BeginTextureMode(canvas); ClearBackground(BLANK); }
-void UIManager::EndUI() { EndTextureMode(); }
-void UIManager::Render() {
-    for (auto& e : elements) {
+void UIManager::DrawMessages() {
+    float offsets[MAX_MESSAGE_GLYPHS];
+
+    messages.ForEach([&](const TextElement& e) {
         float timeActive = e.maxLifetime - e.lifetime;
-        
-        for (int i = 0; i < e.text.length(); i++) {
-            Vector2 charPos = { e.position.x + (i * e.fontSize * 0.5f), e.position.y };
-            
-            // SEQUENTIAL WIGGLE LOGIC
-            // Each letter wiggles when timeActive hits its specific slot (0.1s delay per char)
-            float charStartTime = i * 0.08f;
-            float charWiggleDuration = 0.3f;
-            
-            if (e.anim == UIAnimType::WIGGLE) {
+        // Letters sit half a font size apart, like the old per-character DrawText
+        const TextLayout& layout = text.Layout(e.text, (int)e.fontSize, e.fontSize * 0.5f);
+        const float *glyphOffsets = nullptr;
+
+        if (e.anim == UIAnimType::WIGGLE && layout.glyphs.size() <= MAX_MESSAGE_GLYPHS) {
+            for (size_t i = 0; i < layout.glyphs.size(); i++) {
+                // SEQUENTIAL WIGGLE LOGIC
+                // Each letter wiggles when timeActive hits its specific slot (0.08s delay per char)
+                float charStartTime = layout.glyphs[i].charIndex * 0.08f;
+                float charWiggleDuration = 0.3f;
+                offsets[i] = 0.0f;
+
                 if (timeActive > charStartTime && timeActive < charStartTime + charWiggleDuration) {
                     float localT = (timeActive - charStartTime) / charWiggleDuration;
-                    charPos.y -= sinf(localT * PI) * 15.0f; // One clean hop/wiggle
+                    offsets[i] = -sinf(localT * PI) * 15.0f; // One clean hop/wiggle
                 }
             }
-
-            DrawText(TextFormat("%c", e.text[i]), charPos.x, charPos.y, e.fontSize, Fade(e.color, e.lifetime / e.maxLifetime));
+            glyphOffsets = offsets;
         }
+
+        text.Draw(layout, e.position, Fade(e.color, e.lifetime / e.maxLifetime), glyphOffsets);
+    });
+}
+
+bool UIManager::BeginUI() {
+    if (!canvasDirty) return false;
+
+    PROFILE_SCOPE(util::PHASE_UI_BEGIN);
+    BeginTextureMode(canvas);
+    ClearBackground(BLANK);
+    text.Begin();
+    canvasDirty = false;
+    return true;
+}
+
+void UIManager::EndUI() {
+    PROFILE_SCOPE(util::PHASE_UI_END);
+    // Every HUD glyph queued since BeginUI goes out as one batch
+    text.Flush();
+    EndTextureMode();
+}
+
+void UIManager::Render(render::CommandBuffer& commands) {
+    commands.Custom(render::RenderPass::POST, [this] { Composite(); }, postMaterial.shader.id);
+}
+
+void UIManager::Composite() {
+    PROFILE_SCOPE(util::PHASE_UI_RENDER);
+    if (backdrop) {
+        CompositeMerged();
+        return;
+    }
+
+    // 1. No pulse: ui_post would pass the canvas through unchanged, so it
+    //    goes straight to the screen without the shader or an offscreen target
+    if (effectTimer <= 0.0f) {
+        render::DrawFullscreenQuad(canvas.texture, { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() }, true);
+        return;
     }
 
     // 2. Draw canvas to screen with shader
-    float time = GetTime();
-    SetShaderValue(uiShader, intensityLoc, &effectTimer, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(uiShader, timeLoc, &time, SHADER_UNIFORM_FLOAT);
+    postMaterial.effectIntensity.Set(effectTimer);
+    postMaterial.time.Set((float)GetTime());
+
+    Vector2 size = postTarget.Begin(resolutionScale);
+        BeginShaderMode(postMaterial.shader);
+            render::DrawFullscreenQuad(canvas.texture, { 0, 0, size.x, size.y }, true);
+        EndShaderMode();
+    postTarget.End();
+    postTarget.Draw();
+}
 
-    BeginShaderMode(uiShader);
-        DrawTextureRec(canvas.texture, (Rectangle){ 0, 0, (float)canvas.texture.width, (float)-canvas.texture.height }, (Vector2){ 0, 0 }, WHITE);
+void UIManager::CompositeMerged() {
+    compositeMaterial.effectIntensity.Set(effectTimer);
+    compositeMaterial.backgroundBlend.Set(backdrop->Blend());
+
+    // Every pixel is written with alpha 1, nothing under it shows through
+    BeginShaderMode(compositeMaterial.shader);
+        compositeMaterial.scene.Set(scene);
+        compositeMaterial.background0.Set(backdrop->Keyframe(0));
+        compositeMaterial.background1.Set(backdrop->Keyframe(1));
+        render::DrawFullscreenQuad(canvas.texture, { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() }, true);
     EndShaderMode();
 }
 
+void UIManager::SetResolutionScale(float scale) {
+    resolutionScale = scale < MIN_POST_SCALE ? MIN_POST_SCALE : scale;
+}
+
+void UIManager::SetBackdrop(const render::BackgroundRenderer *background, Texture2D scene) {
+    backdrop = background;
+    this->scene = scene;
+}
+
 }
\ No newline at end of file
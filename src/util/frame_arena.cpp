@@ -0,0 +1,86 @@
+#include "util/frame_arena.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+namespace util {
+
+static size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameArena& FrameArena::Instance() {
+  static FrameArena instance;
+  return instance;
+}
+
+FrameArena::FrameArena(size_t capacity)
+  : base((uint8_t *)malloc(capacity)), capacity(capacity) {}
+
+FrameArena::~FrameArena() {
+  // No Reset(), it would regrow the block only to free it
+  FreeOverflow();
+  free(base);
+}
+
+void *FrameArena::Allocate(size_t bytes, size_t alignment) {
+  // The block itself is max_align_t aligned, offsets only need rounding
+  size_t start = AlignUp(offset, alignment);
+  if (start + bytes <= capacity) {
+    offset = start + bytes;
+    return base + start;
+  }
+
+  // Out of room: the heap covers the rest of this frame, Reset() regrows
+  size_t header = AlignUp(sizeof(OverflowBlock), alignment);
+  OverflowBlock *block = (OverflowBlock *)malloc(header + bytes);
+  block->next = overflow;
+  overflow = block;
+  overflowBytes += bytes;
+  overflows++;
+  return (uint8_t *)block + header;
+}
+
+const char *FrameArena::Format(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  int length = vsnprintf(nullptr, 0, format, copy);
+  va_end(copy);
+
+  char *text = AllocateArray<char>(length > 0 ? length + 1 : 1);
+  text[0] = '\0';
+  if (length > 0) vsnprintf(text, length + 1, format, args);
+  va_end(args);
+  return text;
+}
+
+void FrameArena::Reset() {
+  size_t used = Used();
+  if (used > peak) peak = used;
+
+  FreeOverflow();
+
+  // Grow between frames rather than spilling to the heap every frame
+  if (overflowBytes > 0) {
+    size_t grown = capacity > 0 ? capacity : FRAME_ARENA_CAPACITY;
+    while (grown < used * 2) grown *= 2;
+    free(base);
+    base = (uint8_t *)malloc(grown);
+    capacity = grown;
+  }
+
+  offset = 0;
+  overflowBytes = 0;
+}
+
+void FrameArena::FreeOverflow() {
+  while (overflow) {
+    OverflowBlock *next = overflow->next;
+    free(overflow);
+    overflow = next;
+  }
+}
+
+}
@@ -0,0 +1,79 @@
+#include "util/mapped_file.h"
+
+// No raylib in here, windows.h would clash with its CloseWindow/DrawText/...
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util {
+
+bool MappedFile::Open(const char *path) {
+  Close();
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  // The mapping keeps the file open on its own
+  HANDLE handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!handle) return false;
+
+  void *view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    CloseHandle(handle);
+    return false;
+  }
+
+  mapping = handle;
+  data = (const uint8_t *)view;
+  size = (size_t)fileSize.QuadPart;
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+
+  // The mapping outlives the descriptor
+  void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (view == MAP_FAILED) return false;
+
+  data = (const uint8_t *)view;
+  size = (size_t)info.st_size;
+#endif
+  return true;
+}
+
+void MappedFile::Close() {
+  if (!data) return;
+
+#if defined(_WIN32)
+  UnmapViewOfFile(data);
+  CloseHandle((HANDLE)mapping);
+#else
+  munmap((void *)data, size);
+#endif
+  data = nullptr;
+  size = 0;
+  mapping = nullptr;
+}
+
+}
@@ -0,0 +1,83 @@
+#include "util/profiler.h"
+#include <cstdio>
+
+namespace util {
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+  "frame", "update", "sim_step", "camera", "ui_update", "background",
+  "render_3d", "ui_begin", "ui_draw", "ui_end", "ui_render", "present"
+};
+
+const char *PhaseName(ProfilePhase phase) {
+  return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+Profiler& Profiler::Instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::EndFrame() {
+  FrameRecord record;
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    record.ms[i] = (float)(pending[i].exchange(0, std::memory_order_relaxed) / 1e6);
+  }
+  if (!IsEnabled()) return;
+
+  // Only the frame thread publishes, so head needs no read-modify-write
+  uint64_t frame = head.load(std::memory_order_relaxed);
+  record.frame = frame;
+  Slot& slot = slots[frame & (PROFILER_HISTORY - 1)];
+
+  // Odd sequence = write in progress
+  uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.record = record;
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+
+  head.store(frame + 1, std::memory_order_release);
+}
+
+size_t Profiler::Snapshot(FrameRecord *out, size_t maxRecords) const {
+  uint64_t end = head.load(std::memory_order_acquire);
+  uint64_t available = end < PROFILER_HISTORY ? end : PROFILER_HISTORY;
+  if (maxRecords > available) maxRecords = (size_t)available;
+
+  size_t count = 0;
+  for (uint64_t frame = end - maxRecords; frame < end; frame++) {
+    const Slot& slot = slots[frame & (PROFILER_HISTORY - 1)];
+
+    uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    FrameRecord record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+
+    // Skip records being (or already) overwritten rather than waiting
+    if ((before & 1) || before != after || record.frame != frame) continue;
+    out[count++] = record;
+  }
+  return count;
+}
+
+bool Profiler::WriteCsv(const char *path) const {
+  FILE *file = fopen(path, "w");
+  if (!file) return false;
+
+  fprintf(file, "frame");
+  for (int i = 0; i < PHASE_COUNT; i++) fprintf(file, ",%s_ms", PHASE_NAMES[i]);
+  fprintf(file, "\n");
+
+  static FrameRecord records[PROFILER_HISTORY];
+  size_t count = Snapshot(records, PROFILER_HISTORY);
+  for (size_t r = 0; r < count; r++) {
+    fprintf(file, "%llu", (unsigned long long)records[r].frame);
+    for (int i = 0; i < PHASE_COUNT; i++) fprintf(file, ",%.4f", records[r].ms[i]);
+    fprintf(file, "\n");
+  }
+
+  fclose(file);
+  return true;
+}
+
+}
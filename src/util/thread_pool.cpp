@@ -0,0 +1,101 @@
+#include "util/thread_pool.h"
+
+namespace util {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+  if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+  if (threadCount == 0) threadCount = 1;
+
+  for (size_t i = 0; i < threadCount; i++) {
+    queues.push_back(std::make_unique<WorkerQueue>());
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  Wait();
+
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(Task task) {
+  // Spread submissions round-robin, stealing evens out the rest
+  size_t index = nextQueue.fetch_add(1) % queues.size();
+  pending.fetch_add(1);
+
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(task));
+  }
+
+  std::lock_guard<std::mutex> lock(sleepMutex);
+  workAvailable.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(sleepMutex);
+  allDone.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool ThreadPool::PopLocal(size_t index, Task& task) {
+  WorkerQueue& queue = *queues[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) return false;
+
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::Steal(size_t thief, Task& task) {
+  for (size_t offset = 1; offset < queues.size(); offset++) {
+    WorkerQueue& victim = *queues[(thief + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (victim.tasks.empty()) continue;
+
+    task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+  while (true) {
+    Task task;
+    if (PopLocal(index, task) || Steal(index, task)) {
+      task();
+
+      if (pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        allDone.notify_all();
+      }
+      continue;
+    }
+
+    // Nothing anywhere, sleep until a Submit or shutdown
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    workAvailable.wait(lock, [this, index] {
+      if (stopping) return true;
+      for (auto& queue : queues) {
+        std::lock_guard<std::mutex> queueLock(queue->mutex);
+        if (!queue->tasks.empty()) return true;
+      }
+      return false;
+    });
+
+    if (stopping) return;
+  }
+}
+
+}
@@ -0,0 +1,102 @@
+#include "test.h"
+#include "entity/debris_pool.h"
+
+static const float STEP = 1.0f / 60.0f;
+static const Vector3 PIECE_SIZE = { 1, 1, 1 };
+static const Vector3 STILL = { 0, 0, 0 };
+// Pieces are told apart by color
+static const math::Color FIRST_COLOR = { 255, 0, 0, 255 };
+static const math::Color SECOND_COLOR = { 0, 255, 0, 255 };
+static const math::Color THIRD_COLOR = { 0, 0, 255, 255 };
+
+static bool Same(math::Color a, math::Color b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+/// @brief A 50x50 floor with its top face at y = 0
+static entity::LayerHash Floor() {
+  entity::LayerHash colliders;
+  colliders.Insert({ 0, -2, 0 }, { 50, 4, 50 });
+  return colliders;
+}
+
+TEST(debris_pool, removes_pieces_below_kill_height) {
+  entity::DebrisPool pool(8);
+  entity::LayerHash colliders = Floor();
+  entity::TowerStore tower;
+
+  // The first falls past the floor's edge, the others are over it
+  CHECK(pool.Spawn({ 100, entity::DEBRIS_KILL_HEIGHT + 0.5f, 0 }, PIECE_SIZE, { 0, -30, 0 }, STILL, FIRST_COLOR));
+  CHECK(pool.Spawn({ 0, 5, 0 }, PIECE_SIZE, STILL, STILL, SECOND_COLOR));
+  CHECK(pool.Spawn({ 5, 5, 5 }, PIECE_SIZE, STILL, STILL, THIRD_COLOR));
+  CHECK(pool.Count() == 3);
+
+  pool.Update(STEP, colliders, tower);
+
+  // Swap-removed: the last piece took the dead one's slot
+  CHECK(pool.Count() == 2);
+  bool first = false, second = false, third = false;
+  for (size_t i = 0; i < pool.Count(); i++) {
+    math::Color color = pool.Color(i);
+    first |= Same(color, FIRST_COLOR);
+    second |= Same(color, SECOND_COLOR);
+    third |= Same(color, THIRD_COLOR);
+  }
+  CHECK(!first && second && third);
+}
+
+TEST(debris_pool, resting_pieces_fall_asleep) {
+  entity::DebrisPool pool(8);
+  entity::LayerHash colliders = Floor();
+  entity::TowerStore tower;
+
+  CHECK(pool.Spawn({ 0, 3, 0 }, PIECE_SIZE, STILL, STILL, FIRST_COLOR));
+  for (int i = 0; i < 300 && pool.Sleeping() == 0; i++) pool.Update(STEP, colliders, tower);
+
+  CHECK(pool.Count() == 1);
+  CHECK(pool.Sleeping() == 1);
+  // Asleep on the floor, not sunk into it
+  CHECK(test::Near(pool.Position(0).y, 0.5f, entity::DEBRIS_CONTACT_SLOP + 0.01f));
+
+  // And nothing moves it any more
+  Vector3 before = pool.Position(0);
+  for (int i = 0; i < 60; i++) pool.Update(STEP, colliders, tower);
+  CHECK(pool.Sleeping() == 1);
+  CHECK(pool.Position(0).y == before.y);
+}
+
+TEST(debris_pool, full_pool_recycles_sleepers) {
+  entity::DebrisPool pool(4);
+  entity::LayerHash colliders = Floor();
+  entity::TowerStore tower;
+
+  // 1. Four pieces in the air: full and nothing to recycle
+  for (int i = 0; i < 4; i++) CHECK(pool.Spawn({ (float)i * 2, 3, 0 }, PIECE_SIZE, STILL, STILL, FIRST_COLOR));
+  CHECK(!pool.Spawn({ 0, 3, 0 }, PIECE_SIZE, STILL, STILL, THIRD_COLOR));
+  CHECK(pool.Count() == 4);
+
+  // 2. Once they sleep, new pieces take their slots
+  for (int i = 0; i < 300 && pool.Sleeping() < 4; i++) pool.Update(STEP, colliders, tower);
+  CHECK(pool.Sleeping() == 4);
+
+  CHECK(pool.Spawn({ 0, 10, 0 }, PIECE_SIZE, STILL, STILL, THIRD_COLOR));
+  CHECK(pool.Count() == 4);
+  CHECK(pool.Sleeping() == 3);
+  CHECK(Same(pool.Color(3), THIRD_COLOR)); // The new one is awake, at the end
+
+  CHECK(pool.Spawn({ 0, 10, 0 }, PIECE_SIZE, STILL, STILL, SECOND_COLOR));
+  CHECK(pool.Count() == 4);
+  CHECK(pool.Sleeping() == 2);
+}
+
+TEST(debris_pool, lands_on_the_tower) {
+  entity::DebrisPool pool(8);
+  entity::LayerHash colliders = Floor();
+  entity::TowerStore tower;
+  tower.Push(entity::Block(0, { 0, 0, 0 }, { 10, 2, 10 }, math::Color::White()));
+  tower.Push(entity::Block(1, { 0, 2, 0 }, { 10, 2, 10 }, math::Color::White()));
+
+  CHECK(pool.Spawn({ 0, 6, 0 }, PIECE_SIZE, STILL, STILL, FIRST_COLOR));
+  for (int i = 0; i < 300 && pool.Sleeping() == 0; i++) pool.Update(STEP, colliders, tower);
+
+  CHECK(pool.Sleeping() == 1);
+  CHECK(test::Near(pool.Position(0).y, 3.5f, entity::DEBRIS_CONTACT_SLOP + 0.01f));
+}
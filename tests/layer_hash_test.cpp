@@ -0,0 +1,60 @@
+#include "test.h"
+#include "entity/layer_hash.h"
+
+/// @brief Terrain with its top at y = 0 and a tower of 10x2x10 blocks on it,
+/// block i's top face at 2i + 1
+static void Build(entity::LayerHash& colliders, entity::TowerStore& tower, int height) {
+  colliders.Insert({ 0, -2, 0 }, { 50, 4, 50 });
+  for (int i = 0; i < height; i++) {
+    tower.Push(entity::Block(i, { 0, 2.0f * i, 0 }, { 10, 2, 10 }, math::Color::White()));
+  }
+}
+
+TEST(layer_hash, finds_the_terrain) {
+  entity::LayerHash colliders;
+  entity::TowerStore tower;
+  Build(colliders, tower, 0);
+
+  float top = -1.0f;
+  CHECK(colliders.FindSupport(tower, 20, -20, -0.5f, 0.5f, top));
+  CHECK(top == 0.0f);
+  CHECK(!colliders.FindSupport(tower, 30, 0, -0.5f, 0.5f, top)); // Off the edge
+  CHECK(!colliders.FindSupport(tower, 0, 0, 1.0f, 3.0f, top));   // Above it
+}
+
+TEST(layer_hash, finds_tower_blocks) {
+  entity::LayerHash colliders;
+  entity::TowerStore tower;
+  Build(colliders, tower, 50);
+
+  // 1. Every layer, the settled blocks and the top one
+  for (int i = 0; i < 50; i++) {
+    float face = 2.0f * i + 1.0f, top = -1.0f;
+    CHECK(colliders.FindSupport(tower, 1, -1, face - 0.3f, face + 0.1f, top));
+    CHECK(test::Near(top, face, 1e-3f));
+  }
+
+  // 2. Outside the footprint only the terrain is there
+  float top = -1.0f;
+  CHECK(!colliders.FindSupport(tower, 8, 0, 20.0f, 30.0f, top));
+  CHECK(colliders.FindSupport(tower, 8, 0, -1.0f, 30.0f, top));
+  CHECK(top == 0.0f);
+
+  // 3. Nothing above the top block
+  CHECK(!colliders.FindSupport(tower, 0, 0, 100.0f, 120.0f, top));
+}
+
+TEST(layer_hash, highest_support_wins) {
+  entity::LayerHash colliders;
+  entity::TowerStore tower;
+  Build(colliders, tower, 10);
+
+  float top = -1.0f;
+  CHECK(colliders.FindSupport(tower, 0, 0, -1.0f, 12.0f, top));
+  CHECK(test::Near(top, 11.0f, 1e-3f));
+
+  // A box sticking out of the tower's side beats the block below it
+  colliders.Insert({ 0, 8.25f, 0 }, { 2, 0.5f, 2 });
+  CHECK(colliders.FindSupport(tower, 0, 0, 6.0f, 8.9f, top));
+  CHECK(test::Near(top, 8.5f, 1e-3f));
+}
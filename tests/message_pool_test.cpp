@@ -0,0 +1,51 @@
+#include "test.h"
+#include "ui/message_pool.h"
+#include <cstring>
+#include <string>
+
+static ui::TextElement& Spawn(ui::MessagePool& pool, const char *text, float lifetime) {
+  ui::TextElement& element = pool.Spawn(text);
+  element.lifetime = lifetime;
+  element.maxLifetime = lifetime;
+  return element;
+}
+
+TEST(message_pool, full_ring_drops_the_oldest) {
+  ui::MessagePool pool;
+  for (int i = 0; i < 40; i++) Spawn(pool, std::to_string(i).c_str(), 1.0f);
+  CHECK(pool.Count() == ui::MAX_UI_MESSAGES);
+
+  // 0..7 were overwritten, 8..39 remain in spawn order
+  int expected = 40 - (int)ui::MAX_UI_MESSAGES;
+  bool ordered = true;
+  pool.ForEach([&](const ui::TextElement& element) {
+    if (std::to_string(expected++) != element.text) ordered = false;
+  });
+  CHECK(ordered);
+  CHECK(expected == 40);
+}
+
+TEST(message_pool, truncates_long_text) {
+  ui::MessagePool pool;
+  std::string text(100, 'x');
+  ui::TextElement& element = Spawn(pool, text.c_str(), 1.0f);
+  CHECK(strlen(element.text) == ui::MAX_MESSAGE_LENGTH - 1);
+}
+
+TEST(message_pool, update_expires_messages) {
+  ui::MessagePool pool;
+  Spawn(pool, "first", 1.0f);
+  Spawn(pool, "short", 0.25f); // Expires behind an older one
+  Spawn(pool, "last", 2.0f);
+
+  pool.Update(0.5f);
+  CHECK(pool.Count() == 3); // The head is still alive
+  int visible = 0;
+  pool.ForEach([&](const ui::TextElement& element) { visible++; CHECK(strcmp(element.text, "short") != 0); });
+  CHECK(visible == 2);
+
+  pool.Update(0.75f);
+  CHECK(pool.Count() == 1);
+  pool.Update(1.0f);
+  CHECK(pool.Count() == 0);
+}
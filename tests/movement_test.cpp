@@ -0,0 +1,60 @@
+#include "test.h"
+#include "entity/movement.h"
+
+static entity::Movement Make(entity::Direction direction, float speed) {
+  entity::Movement movement;
+  movement.speed = speed;
+  movement.direction = direction;
+  movement.axis = entity::X;
+  return movement;
+}
+
+TEST(movement, starts_where_it_is_put) {
+  for (entity::Direction direction : { entity::FORWARD, entity::BACKWARD }) {
+    for (float start : { -20.0f, -7.5f, 0.0f, 12.25f, 20.0f }) {
+      entity::Movement movement = Make(direction, 8.0f);
+      movement.Start(start);
+      CHECK(test::Near(movement.PositionAt(0.0f), start, 1e-4f));
+
+      // A moment later it has moved the right way
+      float next = movement.PositionAt(0.01f);
+      if (start > -20.0f && start < 20.0f) {
+        CHECK(direction == entity::FORWARD ? next > start : next < start);
+      }
+    }
+  }
+}
+
+TEST(movement, stays_within_threshold) {
+  entity::Movement movement = Make(entity::FORWARD, 13.0f);
+  movement.Start(3.0f);
+  for (float t = -50.0f; t < 50.0f; t += 0.173f) {
+    float x = movement.PositionAt(t);
+    CHECK(x >= -movement.threshold - 1e-4f && x <= movement.threshold + 1e-4f);
+  }
+}
+
+TEST(movement, update_matches_position_at) {
+  entity::Movement stepped = Make(entity::BACKWARD, 10.0f);
+  stepped.Start(5.0f);
+  entity::Movement reference = stepped;
+
+  Vector3 position = { 5.0f, 0, 0 };
+  const float STEP = 1.0f / 120.0f;
+  for (int i = 1; i <= 2000; i++) {
+    stepped.Update(position, STEP);
+    CHECK(test::Near(position.x, reference.PositionAt(i * STEP), 1e-2f));
+  }
+}
+
+TEST(movement, time_until_reaches_position) {
+  for (entity::Direction direction : { entity::FORWARD, entity::BACKWARD }) {
+    entity::Movement movement = Make(direction, 6.0f);
+    movement.Start(-4.0f);
+    for (float target = -19.0f; target <= 19.0f; target += 2.5f) {
+      float wait = movement.TimeUntil(target);
+      CHECK(wait >= 0.0f && wait < 4.0f * movement.threshold / movement.speed);
+      CHECK(test::Near(movement.PositionAt(wait), target, 1e-3f));
+    }
+  }
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+#include "sim/autoplayer.h"
+#include "sim/fixed_timestep.h"
+#include "sim/replay.h"
+#include <cstdio>
+
+static const char *REPLAY_TEST_FILE = "test_replays.tbr";
+
+/// @brief Plays a whole run with the bot, recording it like the game does
+static sim::ReplayRun PlayRun(uint64_t seed) {
+  sim::Simulation simulation;
+  simulation.Reset(seed);
+  sim::AutoPlayer player(sim::SkillProfile::Casual(), seed);
+  sim::ReplayRecorder recorder;
+  recorder.Begin(seed, (uint32_t)(1.0f / sim::SIMULATION_STEP + 0.5f));
+
+  while (simulation.state != sim::GAME_OVER_STATE && simulation.tick < 100000) {
+    sim::Input input = player.Decide(simulation, sim::SIMULATION_STEP);
+    if (input.press) recorder.RecordPress(simulation.tick, input.subTick);
+    simulation.Step(input, sim::SIMULATION_STEP);
+  }
+  return recorder.Finish(simulation);
+}
+
+TEST(replay, round_trip_verifies) {
+  remove(REPLAY_TEST_FILE);
+  sim::ReplayRun runs[3] = { PlayRun(1), PlayRun(2), PlayRun(3) };
+  {
+    sim::ReplayWriter writer;
+    CHECK(writer.Open(REPLAY_TEST_FILE));
+    for (const sim::ReplayRun& run : runs) writer.Write(run);
+  }
+
+  sim::ReplayReader reader;
+  CHECK(reader.Open(REPLAY_TEST_FILE));
+  sim::Simulation simulation;
+  sim::ReplayPlayer player(simulation);
+
+  sim::ReplayRun run;
+  size_t count = 0;
+  while (reader.Next(run)) {
+    CHECK(count < 3);
+    if (count >= 3) break;
+    CHECK(run.seed == runs[count].seed);
+    CHECK(run.pressTicks == runs[count].pressTicks);
+    CHECK(run.pressSubTicks == runs[count].pressSubTicks);
+    CHECK(run.score > 0);
+    CHECK(player.Verify(run));
+
+    // A doctored result must not verify
+    run.towerHash ^= 1;
+    CHECK(!player.Verify(run));
+    count++;
+  }
+  CHECK(count == 3);
+  CHECK(reader.Error() == nullptr);
+  remove(REPLAY_TEST_FILE);
+}
+
+TEST(replay, skips_unknown_versions) {
+  remove(REPLAY_TEST_FILE);
+
+  // A record from a future version: magic, version, length, body
+  FILE *file = fopen(REPLAY_TEST_FILE, "wb");
+  uint32_t magic = sim::REPLAY_MAGIC;
+  fwrite(&magic, sizeof(magic), 1, file);
+  const uint8_t future[] = { (uint8_t)(sim::REPLAY_VERSION + 1), 3, 0xAA, 0xBB, 0xCC };
+  fwrite(future, 1, sizeof(future), file);
+  fclose(file);
+
+  sim::ReplayRun written = PlayRun(4);
+  {
+    sim::ReplayWriter writer;
+    writer.Open(REPLAY_TEST_FILE);
+    writer.Write(written);
+  }
+
+  sim::ReplayReader reader;
+  sim::ReplayRun run;
+  CHECK(reader.Open(REPLAY_TEST_FILE));
+  CHECK(reader.Next(run));
+  CHECK(run.seed == written.seed && run.towerHash == written.towerHash);
+  CHECK(!reader.Next(run));
+  CHECK(reader.Skipped() == 1);
+  CHECK(reader.Error() == nullptr);
+  remove(REPLAY_TEST_FILE);
+}
+
+TEST(replay, reports_garbage) {
+  remove(REPLAY_TEST_FILE);
+  {
+    sim::ReplayWriter writer;
+    writer.Open(REPLAY_TEST_FILE);
+    writer.Write(PlayRun(5));
+  }
+  FILE *file = fopen(REPLAY_TEST_FILE, "ab");
+  fputs("not a replay", file);
+  fclose(file);
+
+  sim::ReplayReader reader;
+  sim::ReplayRun run;
+  CHECK(reader.Open(REPLAY_TEST_FILE));
+  CHECK(reader.Next(run));
+  // The end of what could be read is not the end of the file
+  CHECK(!reader.Next(run));
+  CHECK(reader.Error() != nullptr);
+  remove(REPLAY_TEST_FILE);
+}
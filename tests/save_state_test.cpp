@@ -0,0 +1,178 @@
+#include "test.h"
+#include "sim/autoplayer.h"
+#include "sim/fixed_timestep.h"
+#include "sim/replay.h"
+#include "sim/save_state.h"
+#include <cstdio>
+#include <vector>
+
+static const char *SAVE_TEST_FILE = "test_save.tbs";
+
+static void Play(sim::Simulation& simulation, sim::AutoPlayer& player, uint64_t steps) {
+  for (uint64_t i = 0; i < steps; i++) {
+    simulation.Step(player.Decide(simulation, sim::SIMULATION_STEP), sim::SIMULATION_STEP);
+  }
+}
+
+/// @brief A run in progress, with a few blocks and some debris about
+static void MidRun(sim::Simulation& simulation) {
+  simulation.Reset(42);
+  sim::AutoPlayer player(sim::SkillProfile::Expert(), 42);
+  Play(simulation, player, 1500);
+}
+
+static bool Save(const sim::Simulation& simulation, const char *path) {
+  sim::SaveWriter writer;
+  writer.Begin();
+  sim::SaveSimulation(writer, simulation);
+  return writer.WriteFile(path);
+}
+
+static std::vector<uint8_t> ReadBytes(const char *path) {
+  std::vector<uint8_t> bytes;
+  FILE *file = fopen(path, "rb");
+  if (!file) return bytes;
+  for (int c = fgetc(file); c != EOF; c = fgetc(file)) bytes.push_back((uint8_t)c);
+  fclose(file);
+  return bytes;
+}
+
+static void WriteBytes(const char *path, const std::vector<uint8_t>& bytes) {
+  FILE *file = fopen(path, "wb");
+  fwrite(bytes.data(), 1, bytes.size(), file);
+  fclose(file);
+}
+
+TEST(save_state, round_trip_continues_identically) {
+  sim::Simulation original;
+  MidRun(original);
+  CHECK(original.state == sim::PLAYING_STATE);
+  CHECK(original.placed_blocks.Size() > 2);
+  CHECK(Save(original, SAVE_TEST_FILE));
+
+  // Loaded over a simulation in some other state entirely
+  sim::Simulation loaded;
+  loaded.Reset(7);
+  sim::SaveReader reader;
+  CHECK(reader.Open(SAVE_TEST_FILE));
+  CHECK(sim::LoadSimulation(reader, loaded));
+
+  CHECK(loaded.tick == original.tick);
+  CHECK(loaded.random.GetState() == original.random.GetState());
+  CHECK(sim::HashTower(loaded) == sim::HashTower(original));
+  CHECK(loaded.debris.Count() == original.debris.Count());
+  CHECK(loaded.debris.Sleeping() == original.debris.Sleeping());
+
+  // Same inputs from here on, same game
+  sim::AutoPlayer first(sim::SkillProfile::Casual(), 9), second(sim::SkillProfile::Casual(), 9);
+  Play(original, first, 3000);
+  Play(loaded, second, 3000);
+  CHECK(loaded.state == original.state);
+  CHECK(loaded.tick == original.tick);
+  CHECK(loaded.random.GetState() == original.random.GetState());
+  CHECK(sim::HashTower(loaded) == sim::HashTower(original));
+  remove(SAVE_TEST_FILE);
+}
+
+TEST(save_state, rejects_truncated_and_corrupt_files) {
+  sim::Simulation simulation;
+  MidRun(simulation);
+  CHECK(Save(simulation, SAVE_TEST_FILE));
+  std::vector<uint8_t> bytes = ReadBytes(SAVE_TEST_FILE);
+  CHECK(bytes.size() > sizeof(sim::SaveHeader));
+
+  sim::SaveReader reader;
+  CHECK(!reader.Open("test_missing.tbs"));
+
+  // 1. Cut short
+  WriteBytes(SAVE_TEST_FILE, std::vector<uint8_t>(bytes.begin(), bytes.end() - 8));
+  CHECK(!reader.Open(SAVE_TEST_FILE));
+  WriteBytes(SAVE_TEST_FILE, std::vector<uint8_t>(bytes.begin(), bytes.begin() + 16));
+  CHECK(!reader.Open(SAVE_TEST_FILE));
+
+  // 2. One byte flipped in the contents, then in the header
+  std::vector<uint8_t> corrupt = bytes;
+  corrupt[sizeof(sim::SaveHeader) + 3] ^= 0x40;
+  WriteBytes(SAVE_TEST_FILE, corrupt);
+  CHECK(!reader.Open(SAVE_TEST_FILE));
+
+  corrupt = bytes;
+  corrupt[4] ^= 0x01; // Version
+  WriteBytes(SAVE_TEST_FILE, corrupt);
+  CHECK(!reader.Open(SAVE_TEST_FILE));
+
+  // 3. And the untouched file still opens
+  WriteBytes(SAVE_TEST_FILE, bytes);
+  CHECK(reader.Open(SAVE_TEST_FILE));
+  CHECK(reader.Error() == nullptr);
+  remove(SAVE_TEST_FILE);
+}
+
+/// @brief Rewrites a valid save with its simulation record and movements
+/// replaced, so the checksum still passes and only LoadSimulation can object
+static bool LoadEdited(const sim::Simulation& source, const sim::SavedSimulation& core,
+                       const std::vector<sim::SavedMovement>& movements, sim::Simulation& target) {
+  sim::SaveReader original;
+  if (!Save(source, SAVE_TEST_FILE) || !original.Open(SAVE_TEST_FILE)) return false;
+
+  size_t settledCount, pieceCount;
+  const entity::PackedBlock *settled = original.Get<entity::PackedBlock>(sim::SAVE_TOWER, settledCount);
+  const entity::DebrisPool::Piece *pieces = original.Get<entity::DebrisPool::Piece>(sim::SAVE_DEBRIS, pieceCount);
+  sim::SaveWriter writer;
+  writer.Begin();
+  writer.Add(sim::SAVE_SIMULATION, core);
+  writer.Add(sim::SAVE_TOWER, settled, settledCount);
+  writer.Add(sim::SAVE_MOVEMENTS, movements.data(), movements.size());
+  writer.Add(sim::SAVE_DEBRIS, pieces, pieceCount);
+
+  const char *EDITED_FILE = "test_save_edited.tbs";
+  sim::SaveReader reader;
+  bool loaded = writer.WriteFile(EDITED_FILE) && reader.Open(EDITED_FILE) && sim::LoadSimulation(reader, target);
+  remove(EDITED_FILE);
+  return loaded;
+}
+
+TEST(save_state, rejects_inconsistent_simulations) {
+  sim::Simulation simulation;
+  MidRun(simulation);
+
+  sim::SaveReader reader;
+  CHECK(Save(simulation, SAVE_TEST_FILE) && reader.Open(SAVE_TEST_FILE));
+  sim::SavedSimulation core;
+  CHECK(reader.Get(sim::SAVE_SIMULATION, core));
+  size_t movementCount;
+  const sim::SavedMovement *saved = reader.Get<sim::SavedMovement>(sim::SAVE_MOVEMENTS, movementCount);
+  CHECK(saved != nullptr && movementCount > 0);
+  std::vector<sim::SavedMovement> movements(saved, saved + movementCount);
+
+  // 1. Unchanged it loads
+  sim::Simulation loaded;
+  CHECK(LoadEdited(simulation, core, movements, loaded));
+  uint64_t hash = sim::HashTower(loaded);
+
+  // 2. The moving block not right above the tower
+  sim::SavedSimulation edited = core;
+  edited.current.index = core.towerSize - 1;
+  CHECK(!LoadEdited(simulation, edited, movements, loaded));
+  edited.current.index = core.towerSize + 5;
+  CHECK(!LoadEdited(simulation, edited, movements, loaded));
+
+  // 3. Playing, but the moving block has no movement
+  std::vector<sim::SavedMovement> others;
+  for (const sim::SavedMovement& movement : movements) {
+    if (movement.owner != core.current.index) others.push_back(movement);
+  }
+  CHECK(others.size() < movements.size());
+  CHECK(!LoadEdited(simulation, core, others, loaded));
+
+  // Before the first press nothing moves yet, that is fine
+  edited = core;
+  edited.state = sim::READY_STATE;
+  sim::Simulation ready;
+  CHECK(LoadEdited(simulation, edited, others, ready));
+
+  // A refused load left the simulation as it was
+  CHECK(sim::HashTower(loaded) == hash);
+  CHECK(loaded.state == sim::PLAYING_STATE);
+  remove(SAVE_TEST_FILE);
+}
@@ -0,0 +1,54 @@
+#pragma once
+// Minimal test harness for the tower_tests executable, in the spirit of
+// bench/bench.h.
+//
+//   TEST(suite, name) { CHECK(condition); }
+//
+// A failed CHECK is reported with its file and line and the test carries on.
+// The executable runs every test, or with --suite NAME only that suite, and
+// exits non-zero if anything failed. CTest runs one suite per test entry.
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace test {
+
+struct Case {
+  const char *suite;
+  const char *name;
+  void (*run)();
+};
+
+inline std::vector<Case>& Registry() {
+  static std::vector<Case> cases;
+  return cases;
+}
+
+struct Registrar {
+  Registrar(const char *suite, const char *name, void (*run)()) { Registry().push_back({ suite, name, run }); }
+};
+
+/// @brief Failed checks of the running test
+inline int& Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline void Fail(const char *file, int line, const char *expression) {
+  fprintf(stderr, "  %s:%d: CHECK(%s) failed\n", file, line, expression);
+  Failures()++;
+}
+
+inline bool Near(float a, float b, float tolerance) { return fabsf(a - b) <= tolerance; }
+
+}
+
+#define TEST(suite, name)                                                            \
+  static void suite##_##name();                                                      \
+  static test::Registrar suite##_##name##_registrar(#suite, #name, suite##_##name);  \
+  static void suite##_##name()
+
+#define CHECK(condition)                                                \
+  do {                                                                  \
+    if (!(condition)) test::Fail(__FILE__, __LINE__, #condition);       \
+  } while (0)
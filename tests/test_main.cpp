@@ -0,0 +1,25 @@
+#include "test.h"
+#include <cstring>
+
+int main(int argc, char **argv) {
+  const char *suite = nullptr;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--suite") == 0) suite = argv[++i];
+  }
+
+  int run = 0, failed = 0;
+  for (const test::Case& testCase : test::Registry()) {
+    if (suite && strcmp(testCase.suite, suite) != 0) continue;
+
+    test::Failures() = 0;
+    testCase.run();
+    bool ok = test::Failures() == 0;
+    printf("%s %s.%s\n", ok ? "[ ok ]" : "[FAIL]", testCase.suite, testCase.name);
+    run++;
+    if (!ok) failed++;
+  }
+
+  printf("%d tests, %d failed\n", run, failed);
+  // A suite name that matches nothing is a broken test list, not a pass
+  return (failed == 0 && run > 0) ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include "test.h"
+#include "util/spsc_queue.h"
+#include "util/triple_buffer.h"
+#include <cstdint>
+#include <thread>
+
+TEST(threading, spsc_queue_keeps_order) {
+  util::SpscQueue<uint64_t, 64> queue;
+  const uint64_t COUNT = 200000;
+
+  // Full is refused rather than overwritten
+  for (uint64_t i = 0; i < 64; i++) CHECK(queue.Push(i));
+  CHECK(!queue.Push(64));
+  uint64_t value;
+  for (uint64_t i = 0; i < 64; i++) CHECK(queue.Pop(value) && value == i);
+  CHECK(!queue.Pop(value));
+
+  // Every value arrives once and in order across threads
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < COUNT; i++) {
+      while (!queue.Push(i)) std::this_thread::yield();
+    }
+  });
+
+  uint64_t expected = 0;
+  bool ordered = true;
+  while (expected < COUNT) {
+    if (!queue.Pop(value)) { std::this_thread::yield(); continue; }
+    if (value != expected) ordered = false;
+    expected++;
+  }
+  producer.join();
+  CHECK(ordered);
+  CHECK(!queue.Pop(value));
+}
+
+struct Frame {
+  uint64_t id = 0;
+  uint64_t check = 0; // Always ~id, a torn frame breaks it
+};
+
+TEST(threading, triple_buffer_hands_off_whole_frames) {
+  util::TripleBuffer<Frame> buffer;
+  const uint64_t LAST = 100000;
+
+  CHECK(!buffer.Acquire()); // Nothing published yet
+
+  std::thread writer([&] {
+    for (uint64_t id = 1; id <= LAST; id++) {
+      Frame& frame = buffer.Back();
+      frame.id = id;
+      frame.check = ~id;
+      buffer.Publish();
+    }
+  });
+
+  uint64_t seen = 0;
+  bool whole = true, forward = true;
+  while (seen < LAST) {
+    if (!buffer.Acquire()) { std::this_thread::yield(); continue; }
+    const Frame& frame = buffer.Front();
+    if (frame.check != ~frame.id) whole = false;
+    if (frame.id <= seen) forward = false;
+    seen = frame.id;
+  }
+  writer.join();
+
+  CHECK(whole);
+  CHECK(forward);
+  CHECK(buffer.Front().id == LAST);
+  CHECK(!buffer.Acquire()); // The last frame is only handed out once
+}
@@ -0,0 +1,59 @@
+#include "test.h"
+#include "entity/tower_store.h"
+
+TEST(tower_store, pack_round_trips_within_quantization) {
+  entity::Block block(7, { 3.14159f, 14.0f, -27.5f }, { 9.87654f, 2.0f, 0.123f }, { 10, 20, 30, 255 });
+  entity::PackedBlock packed = entity::Pack(block);
+  entity::Block unpacked = entity::Unpack(packed, 7);
+
+  CHECK(unpacked.index == 7);
+  CHECK(unpacked.position.y == block.position.y); // Heights are stored exactly
+  CHECK(test::Near(unpacked.position.x, block.position.x, 0.5f / entity::TOWER_POSITION_SCALE));
+  CHECK(test::Near(unpacked.position.z, block.position.z, 0.5f / entity::TOWER_POSITION_SCALE));
+  CHECK(test::Near(unpacked.size.x, block.size.x, 0.5f / entity::TOWER_SIZE_SCALE));
+  CHECK(test::Near(unpacked.size.z, block.size.z, 0.5f / entity::TOWER_SIZE_SCALE));
+  CHECK(test::Near(unpacked.size.y, block.size.y, 0.5f / entity::TOWER_HEIGHT_SCALE));
+  CHECK(unpacked.color.r == 10 && unpacked.color.g == 20 && unpacked.color.b == 30);
+}
+
+TEST(tower_store, pack_clamps_out_of_range_values) {
+  entity::Block block(0, { 40.0f, 0, -40.0f }, { 20.0f, 30.0f, -1.0f }, math::Color::White());
+  entity::Block unpacked = entity::Unpack(entity::Pack(block), 0);
+
+  // Saturated at the edge of the range rather than wrapped around
+  CHECK(test::Near(unpacked.position.x, 32.0f, 0.01f));
+  CHECK(test::Near(unpacked.position.z, -32.0f, 0.01f));
+  CHECK(test::Near(unpacked.size.x, 16.0f, 0.01f));
+  CHECK(test::Near(unpacked.size.y, 15.9375f, 0.01f));
+  CHECK(unpacked.size.z == 0.0f);
+}
+
+TEST(tower_store, push_settles_the_old_top) {
+  entity::TowerStore tower;
+  CHECK(tower.Empty());
+  CHECK(tower.Size() == 0);
+
+  for (int i = 0; i < 5; i++) {
+    tower.Push(entity::Block(99, { (float)i, 2.0f * i, 0 }, { 10, 2, 10 }, math::Color::White()));
+  }
+  CHECK(tower.Size() == 5);
+  CHECK(tower.Top().index == 4); // Renumbered by the store
+  CHECK(tower.Top().position.x == 4.0f);
+  for (size_t i = 0; i < 5; i++) {
+    CHECK(tower.Get(i).index == i);
+    CHECK(test::Near(tower.Get(i).position.x, (float)i, 1e-3f));
+    CHECK(tower.Get(i).position.y == 2.0f * i);
+  }
+
+  // Assign rebuilds the same tower from its records
+  entity::TowerStore copy;
+  copy.Assign(tower.SettledData(), tower.Size() - 1, tower.Top());
+  CHECK(copy.Size() == tower.Size());
+  for (size_t i = 0; i < copy.Size(); i++) {
+    CHECK(copy.Get(i).position.x == tower.Get(i).position.x);
+    CHECK(copy.Get(i).position.y == tower.Get(i).position.y);
+  }
+
+  tower.Clear();
+  CHECK(tower.Empty());
+}
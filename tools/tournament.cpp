@@ -0,0 +1,149 @@
+// Plays thousands of bot games across every core and reports the score
+// distribution, for tuning the speed curve and the perfect-snap window.
+//
+//   tournament [--games N] [--skill perfect|expert|casual|novice] [--threads N]
+//              [--base-speed F] [--speed-per-block F] [--perfect F] [--seed N]
+#include "sim/autoplayer.h"
+#include "sim/fixed_timestep.h"
+#include "sim/simulation.h"
+#include "util/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Stops bots that would otherwise stack forever
+const uint64_t MAX_SCORE = 5000;
+const size_t GAMES_PER_TASK = 16;
+
+struct GameResult {
+  uint64_t score;
+  uint64_t perfects;
+  uint64_t ticks;
+};
+
+static GameResult PlayGame(sim::SkillProfile skill, sim::Tuning tuning, uint64_t seed) {
+  sim::Simulation simulation(seed);
+  simulation.tuning = tuning;
+  sim::AutoPlayer bot(skill, seed * 0x9E3779B97F4A7C15ull + 1);
+
+  const float dt = sim::SIMULATION_STEP;
+  GameResult result = {};
+
+  while (simulation.state != sim::GAME_OVER_STATE && simulation.Score() < MAX_SCORE) {
+    sim::StepEvents events = simulation.Step(bot.Decide(simulation, dt), dt);
+    if (events.perfect) result.perfects++;
+  }
+
+  result.score = simulation.Score();
+  result.ticks = simulation.tick;
+  return result;
+}
+
+static bool ParseSkill(const char *name, sim::SkillProfile& skill) {
+  const sim::SkillProfile profiles[] = {
+    sim::SkillProfile::Perfect(), sim::SkillProfile::Expert(),
+    sim::SkillProfile::Casual(), sim::SkillProfile::Novice()
+  };
+
+  for (const auto& profile : profiles) {
+    if (strcmp(profile.name, name) == 0) {
+      skill = profile;
+      return true;
+    }
+  }
+  return false;
+}
+
+static uint64_t Percentile(const std::vector<uint64_t>& sorted, double p) {
+  size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+int main(int argc, char **argv) {
+  size_t games = 10000;
+  size_t threads = 0;
+  uint64_t seed = 1;
+  sim::SkillProfile skill = sim::SkillProfile::Casual();
+  sim::Tuning tuning;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (hasValue && strcmp(argv[i], "--games") == 0) games = strtoull(argv[++i], nullptr, 10);
+    else if (hasValue && strcmp(argv[i], "--threads") == 0) threads = strtoull(argv[++i], nullptr, 10);
+    else if (hasValue && strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[++i], nullptr, 10);
+    else if (hasValue && strcmp(argv[i], "--base-speed") == 0) tuning.baseSpeed = strtof(argv[++i], nullptr);
+    else if (hasValue && strcmp(argv[i], "--speed-per-block") == 0) tuning.speedPerBlock = strtof(argv[++i], nullptr);
+    else if (hasValue && strcmp(argv[i], "--perfect") == 0) tuning.perfectThreshold = strtof(argv[++i], nullptr);
+    else if (hasValue && strcmp(argv[i], "--skill") == 0) {
+      if (!ParseSkill(argv[++i], skill)) {
+        fprintf(stderr, "Unknown skill %s\n", argv[i]);
+        return 1;
+      }
+    } else {
+      fprintf(stderr, "Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (games == 0) return 0;
+
+  std::vector<GameResult> results(games);
+  auto start = std::chrono::steady_clock::now();
+
+  {
+    util::ThreadPool pool(threads);
+    printf("Playing %zu games (%s) on %zu threads\n", games, skill.name, pool.ThreadCount());
+
+    // Every game writes to its own slot, no locking needed
+    for (size_t first = 0; first < games; first += GAMES_PER_TASK) {
+      size_t last = std::min(first + GAMES_PER_TASK, games);
+      pool.Submit([&results, skill, tuning, seed, first, last] {
+        for (size_t game = first; game < last; game++) {
+          results[game] = PlayGame(skill, tuning, seed + game);
+        }
+      });
+    }
+    pool.Wait();
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<uint64_t> scores;
+  uint64_t perfects = 0, placements = 0, ticks = 0, capped = 0;
+  for (const auto& result : results) {
+    scores.push_back(result.score);
+    perfects += result.perfects;
+    placements += result.score;
+    ticks += result.ticks;
+    if (result.score >= MAX_SCORE) capped++;
+  }
+  std::sort(scores.begin(), scores.end());
+
+  double mean = (double)placements / games;
+  printf("base speed %.2f, speed per block %.2f, perfect window %.2f\n",
+         tuning.baseSpeed, tuning.speedPerBlock, tuning.perfectThreshold);
+  printf("score  min %llu  p10 %llu  p50 %llu  p90 %llu  p99 %llu  max %llu  mean %.1f\n",
+         (unsigned long long)scores.front(), (unsigned long long)Percentile(scores, 0.10),
+         (unsigned long long)Percentile(scores, 0.50), (unsigned long long)Percentile(scores, 0.90),
+         (unsigned long long)Percentile(scores, 0.99), (unsigned long long)scores.back(), mean);
+  printf("perfect rate %.1f%%, %llu games hit the %llu cap\n",
+         placements ? 100.0 * perfects / placements : 0.0, (unsigned long long)capped, (unsigned long long)MAX_SCORE);
+
+  // Ten equal-width buckets up to the best score
+  const int buckets = 10;
+  uint64_t width = scores.back() / buckets + 1;
+  std::vector<size_t> histogram(buckets, 0);
+  for (uint64_t score : scores) histogram[std::min<uint64_t>(score / width, buckets - 1)]++;
+
+  for (int b = 0; b < buckets; b++) {
+    int bar = (int)(50.0 * histogram[b] / games + 0.5);
+    printf("%6llu-%-6llu %7zu %.*s\n", (unsigned long long)(b * width), (unsigned long long)((b + 1) * width - 1),
+           histogram[b], bar, "##################################################");
+  }
+
+  printf("%.2f s, %.0f games/s, %.1f M steps/s\n", seconds, games / seconds, ticks / seconds / 1e6);
+  return 0;
+}